@@ -1,5 +1,5 @@
 NODE(LevelRoot,
-    Node*(*next_level)();
+    const char* next_level; // name of the next level's script function
     float cam_x, cam_y;
 )
 
@@ -10,12 +10,17 @@ NODE(Tilemap,
     int start_x, start_y, end_x, end_y;
     uint8_t* tiles;
     uint8_t(*oob_tile_provider)(void* tilemap, int x, int y);
+    void* cached_tileset;
+    struct CollisionMask* collision_mask;
+    struct SpatialIndex* spatial_index;
+    struct TileStream* stream;
 )
 
 NODE(Tileset,
     Texture* tileset;
     int tile_width, tile_height;
     int tiles_per_row;
+    struct TilesetCache* cache;
 )
 
 NODE(Tile,
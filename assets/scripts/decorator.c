@@ -2,14 +2,14 @@
 
 typedef Tile(*Decorator)(TilemapNode* tilemap, int x, int y);
 
+Tile decorate_tile(TilemapNode* tilemap, int x, int y, Decorator decorator) -> decorator(tilemap, x, y);
+
 NodeBuilder* decorate(NodeBuilder* this, Decorator decorator) {
     if (engine.editor_mode()) return this;
     if (!this.curr_node || this.curr_node.children_size == 0) return this;
     TilemapNode* tilemap = this.curr_node.children[this.curr_node.children_size - 1];
-    for (int y = tilemap.start_y; y < tilemap.end_y; y++) {
-        for (int x = tilemap.start_x; x < tilemap.end_x; x++) {
-            tilemap.set(x, y, decorator(tilemap, x, y));
-        }
-    }
+    // streamed maps get decorated chunk by chunk as they load, mapping them would page in the whole level
+    if (tilemap.stream) tilemap.map_lazily(decorate_tile, decorator);
+    else tilemap.map(tilemap.start_x, tilemap.start_y, tilemap.end_x, tilemap.end_y, decorate_tile, decorator);
     return this;
 }
@@ -102,39 +102,32 @@ void editor_export() {
     LevelRootNode* level = engine.level();
     EntityNode* player = level.find("player");
     TilemapNode* tilemap = player.node.parent;
-    TilesetNode* tileset = tilemap.tileset();
+    EntityNode* start = tilemap.find("start");
+    if (!start) start = player;
+
+    float old_x = player.pos_x, old_y = player.pos_y;
+    player.pos_x = start.pos_x;
+    player.pos_y = start.pos_y;
+    bool saved = tilemap.save("grass_oob_provider", "assets/levels/export.lvl");
+    player.pos_x = old_x;
+    player.pos_y = old_y;
+    if (!saved) {
+        printf("Failed to write 'assets/levels/export.lvl'\n");
+        return;
+    }
 
-    int width = tilemap.end_x - tilemap.start_x, height = tilemap.end_y - tilemap.start_y;
     printf("Node* level() -> engine.open<LevelRootNode>()\n");
-    printf("    .prop<Level>(level) // next_level\n");
+    printf("    .prop<const char*>(\"level\") // next_level\n");
     printf("    .exec(grass_bg)\n");
     printf("    .open<TilemapNode>()\n");
     printf("        .attach(tileset_grass())\n");
     printf("        .prop<float>(1.0f) // scale_x\n");
     printf("        .prop<float>(1.0f) // scale_y\n");
-    printf("        .prop<float>(%d.0f) // scroll_offset_x\n", tilemap.start_x);
-    printf("        .prop<float>(%d.0f) // scroll_offset_y\n", tilemap.start_y);
+    printf("        .prop<float>(0.0f) // scroll_offset_x\n");
+    printf("        .prop<float>(0.0f) // scroll_offset_y\n");
     printf("        .prop<float>(1.0f) // scroll_speed_x\n");
     printf("        .prop<float>(1.0f) // scroll_speed_y\n");
-    printf("        .tilemap(%d, %d, grass_oob_provider, (Tile[]){\n", width, height);
-    for (int y = 0; y < height; y++) {
-        printf("            ");
-        for (int x = 0; x < width; x++) {
-            int tile = tilemap.get(x, y);
-            printf("%d,", tile);
-        }
-        printf("\n");
-    }
-    printf("        })\n");
-    EntityNode* start = player;
-    for (int i = 0; i < tilemap.node.children_size; i++) {
-        if (tilemap.node.children[i] && (int)tilemap.node.children[i].type == NodeType_Entity && tilemap.node.children[i] != player) {
-            EntityNode* entity = tilemap.node.children[i];
-            if (entity.name && strcmp(entity.name, "start") == 0) start = entity;
-            printf("        .attach(%s(%.1ff, %.1ff))\n", entity.func, entity.pos_x, entity.pos_y);
-        }
-    }
-    printf("        .attach(%s(%.1ff, %.1ff))\n", player.func, start.pos_x, start.pos_y);
+    printf("        .tilemap_from_asset(\"levels/export.lvl\")\n");
     printf("    .close()\n");
     printf(".build();\n");
 }
@@ -279,7 +272,7 @@ void editor_update() {
         if (editor_mode == EditorMode_Tilemap) {
             if (editor_tool == EditorTool_Pencil) {
                 if (input.down("ctrl")) editor_curr_tile = tilemap.get(floorf(sel_x), floorf(sel_y));
-                else if (input.down("shift")) {} // bucket fill
+                else if (input.down("shift")) tilemap.flood_fill(floorf(sel_x), floorf(sel_y), editor_curr_tile);
                 else tilemap.set(floorf(sel_x), floorf(sel_y), editor_curr_tile);
             }
             if (editor_tool == EditorTool_Eraser) tilemap.set(floorf(sel_x), floorf(sel_y), 0);
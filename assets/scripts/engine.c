@@ -21,6 +21,8 @@ typedef union {
 typedef struct {
     Color* colors;
     int width, height;
+    int slot;
+    unsigned generation;
 } Texture;
 
 typedef unsigned char Tile;
@@ -50,6 +52,19 @@ typedef enum {
     Collision_Solid,
 } Collision;
 
+typedef enum {
+    CollisionFlag_Solid   = 1 << 0,
+    CollisionFlag_TopOnly = 1 << 1,
+    CollisionFlag_Event   = 1 << 2,
+} CollisionFlag;
+
+typedef enum {
+    Pacing_Uncapped,
+    Pacing_VSync,
+    Pacing_Limit,
+    Pacing_Adaptive,
+} PacingMode;
+
 typedef enum {
     MouseButton_Left   = 1 << 0,
     MouseButton_Middle = 1 << 1,
@@ -80,6 +95,7 @@ typedef struct Assets Assets;
 typedef struct Input Input;
 typedef struct Storage Storage;
 typedef struct StorageSlot StorageSlot;
+typedef struct LevelAsset LevelAsset;
 
 typedef Node*(*Level)();
 typedef void(*FileWatchCallback)(const char* filename);
@@ -90,13 +106,32 @@ extern("engine_delete_node") void __engine_delete_node(Node* node);
 extern("engine_deep_copy") Node* __engine_copy_node(Node* node);
 extern("engine_set_tile") void __engine_set_tile(TilemapNode* node, int x, int y, Tile tile);
 extern("engine_get_tile") uint8_t __engine_get_tile(TilemapNode* node, int x, int y);
+extern("engine_get_tiles") void __engine_get_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t* out);
+extern("engine_fill_tiles") void __engine_fill_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, Tile tile);
+extern("engine_map_tiles") void __engine_map_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, void* func, void* data);
+extern("engine_copy_tiles") void __engine_copy_tiles(TilemapNode* dst, int dst_x, int dst_y, TilemapNode* src, int min_x, int min_y, int max_x, int max_y);
+extern("engine_flood_fill") int __engine_flood_fill(TilemapNode* node, int x, int y, Tile tile);
 extern("engine_property") void* __engine_property(EntityNode* node, const char* name);
 extern("engine_find_entity") EntityNode* __engine_find_entity(LevelRootNode* level, const char* name);
 extern("engine_find_entity_on_tilemap") EntityNode* __engine_find_entity_on_tilemap(TilemapNode* tilemap, const char* name);
 extern("engine_update") void __engine_update(LevelRootNode* node, float delta_time);
 extern("engine_render") void __engine_render(LevelRootNode* node, float width, float height);
+extern("engine_entity_screen_pos") void __engine_entity_screen_pos(EntityNode* entity, float* x, float* y);
 extern("engine_cleanup") void __engine_cleanup();
+extern("engine_load_level_tilemap") void __engine_load_level_tilemap(TilemapNode* tilemap, LevelAsset* asset);
+extern("engine_level_oob_provider") const char* __engine_level_oob_provider(LevelAsset* asset);
+extern("engine_level_spawn") const char* __engine_level_spawn(LevelAsset* asset, int index, float* x, float* y);
+extern("engine_stream_tilemap") void __engine_stream_tilemap(TilemapNode* tilemap, LevelAsset* asset, int budget, int fallback_tile, void* spawn, float focus_x, float focus_y);
+extern("engine_stream_decorate") void __engine_stream_decorate(TilemapNode* tilemap, void* func, void* data);
+extern("engine_save_level_asset") bool __engine_save_level_asset(TilemapNode* tilemap, const char* oob_tile_provider, const char* filename);
 extern("engine_get_tileset") TilesetNode* __engine_get_tileset(TilemapNode* tilemap);
+extern("engine_overlaps_solid") bool __engine_overlaps_solid(TilemapNode* tilemap, float x1, float y1, float x2, float y2, int flags);
+extern("engine_raycast") bool __engine_raycast(TilemapNode* tilemap, float x, float y, float dir_x, float dir_y, float max_dist, int flags, int* hit_x, int* hit_y, float* dist);
+extern("engine_ground_probe") float __engine_ground_probe(TilemapNode* tilemap, float x, float y, float max_depth);
+extern("engine_query_radius") int __engine_query_radius(TilemapNode* tilemap, float x, float y, float r, void* callback, void* data);
+extern("engine_query_box") int __engine_query_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, void* callback, void* data);
+extern("engine_find_radius") int __engine_find_radius(TilemapNode* tilemap, float x, float y, float r, EntityNode** out, int capacity);
+extern("engine_find_box") int __engine_find_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, EntityNode** out, int capacity);
 
 extern("graphics_open") Window* __graphics_open(const char* title, int width, int height);
 extern("graphics_close") void __graphics_close(Window* window);
@@ -109,10 +144,15 @@ extern("graphics_start_frame") void __graphics_start_frame(Window* window);
 extern("graphics_end_frame") void __graphics_end_frame(Window* window);
 extern("graphics_post_process") void __graphics_post_process(Window* window, Shader* shader);
 extern("graphics_set_shader") void __graphics_set_shader(Window* window, Shader* shader);
+extern("graphics_set_uniform") void __graphics_set_uniform(Shader* shader, const char* name, float x, float y, float z, float w);
 extern("graphics_rect") void __graphics_rect(Window* window, float x, float y, float w, float h, int color);
 extern("graphics_draw") void __graphics_draw(Window* window, Texture* texture, float x, float y, float w, float h, float sx, float sy, float sw, float sh, int color);
+extern("graphics_text") void __graphics_text(Window* window, Texture* font, float x, float y, int scale, int color, const char* text);
+extern("graphics_static_text") void __graphics_static_text(Window* window, Texture* font, float x, float y, int scale, int color, const char* text);
+extern("graphics_nine_slice") void __graphics_nine_slice(Window* window, Texture* texture, float sx, float sy, float sw, float sh, float inset, float x, float y, float w, float h, int color);
 extern("graphics_blit") void __graphics_blit(Window* window, Buffer* buffer,  float x, float y, float w, float h, float sx, float sy, float sw, float sh, int color);
 extern("graphics_new_buffer") Buffer* __graphics_new_buffer(Window* window, int width, int height);
+extern("graphics_frame_buffer") Buffer* __graphics_frame_buffer(Window* window, int width, int height);
 extern("graphics_set_buffer") void __graphics_set_buffer(Window* window, Buffer* buffer);
 extern("graphics_destroy_buffer") void __graphics_destroy_buffer(Buffer* buffer);
 extern("graphics_should_close") bool __graphics_should_close();
@@ -161,6 +201,15 @@ extern("watch_file") void __watch_file(const char* filename, FileWatchCallback c
 extern("check_watched_files") void __check_watched_files();
 
 extern("check_editor_mode") bool __editor_mode();
+extern("get_script_symbol") void* __get_script_symbol(const char* name);
+extern("reload_prefetch") void __prefetch_script_symbol(const char* name);
+extern("reload_compile_prefetched") void __compile_prefetched_scripts();
+extern("reload_pending") bool __reload_pending();
+extern("capture_toggle") void __capture_toggle();
+extern("capture_frame") void __capture_frame(Window* window, Buffer* buffer, int width, int height);
+extern("pacing_set_mode") void __pacing_set_mode(PacingMode mode, float rate);
+extern("pacing_end_frame") void __pacing_end_frame(Window* window);
+extern("reload_apply") bool __reload_apply();
 
 LevelRootNode* __curr_level_node;
 Level __curr_level_loader;
@@ -197,6 +246,13 @@ uint64_t get_millis(Engine* this) -> __get_micros() / 1000;
 void watch_file(Engine* this, const char* filename, FileWatchCallback callback) -> __watch_file(filename, callback);
 void check_watched_files(Engine* this) -> __check_watched_files();
 bool editor_mode(Engine* this) -> __editor_mode();
+void compile_prefetched(Engine* this) -> __compile_prefetched_scripts();
+bool reload_pending(Engine* this) -> __reload_pending();
+void toggle_capture(Engine* this) -> __capture_toggle();
+void capture_frame(Engine* this, Window* window, Buffer* buffer, int width, int height) -> __capture_frame(window, buffer, width, height);
+void set_pacing(Engine* this, PacingMode mode, float rate) -> __pacing_set_mode(mode, rate);
+void pace_frame(Engine* this, Window* window) -> __pacing_end_frame(window);
+bool apply_reloads(Engine* this) -> __reload_apply();
 bool create_transition(Engine* this, void(*func)(), float time, int direction) {
     if (__curr_transition.progress < 1) return false;
     __curr_transition.func = func;
@@ -212,7 +268,14 @@ void delete(Node* this) -> __engine_delete_node(this);
 Node* copy(Node* this) -> __engine_copy_node(this);
 void set(TilemapNode* this, int x, int y, Tile tile) -> __engine_set_tile(this, x, y, tile);
 uint8_t get(TilemapNode* this, int x, int y) -> __engine_get_tile(this, x, y);
+void get_tiles(TilemapNode* this, int min_x, int min_y, int max_x, int max_y, uint8_t* out) -> __engine_get_tiles(this, min_x, min_y, max_x, max_y, out);
+void fill(TilemapNode* this, int min_x, int min_y, int max_x, int max_y, Tile tile) -> __engine_fill_tiles(this, min_x, min_y, max_x, max_y, tile);
+void map(TilemapNode* this, int min_x, int min_y, int max_x, int max_y, void* func, void* data) -> __engine_map_tiles(this, min_x, min_y, max_x, max_y, func, data);
+void map_lazily(TilemapNode* this, void* func, void* data) -> __engine_stream_decorate(this, func, data);
+void blit(TilemapNode* this, int dst_x, int dst_y, TilemapNode* src, int min_x, int min_y, int max_x, int max_y) -> __engine_copy_tiles(this, dst_x, dst_y, src, min_x, min_y, max_x, max_y);
+int flood_fill(TilemapNode* this, int x, int y, Tile tile) -> __engine_flood_fill(this, x, y, tile);
 <T> T* prop(EntityNode* this, const char* name) -> (T*)__engine_property(this, name);
+void screen_pos(EntityNode* this, float* x, float* y) -> __engine_entity_screen_pos(this, x, y);
 
 void damage(EntityNode* this, EntityNode* source) {
     for (int i = 0; i < this.node.children_size; i++) {
@@ -227,14 +290,32 @@ void load(Engine* this, Level level) {
     if (__curr_level_node) __curr_level_node.node.delete();
     __curr_level_loader = level;
     __curr_level_node = level();
+    if (__curr_level_node.next_level) __prefetch_script_symbol(__curr_level_node.next_level);
 }
 
 void reload(Engine* this) -> this.load(__curr_level_loader);
 LevelRootNode* level(Engine* this) -> __curr_level_node;
+
+// stays on the current level if the next one can't be found, reloading a NULL loader would crash
+Level next_loader(LevelRootNode* this) {
+    Level next = this.next_level ? __get_script_symbol(this.next_level) : NULL;
+    if (next) return next;
+    printf("Level '%s' not found, staying on the current level\n", this.next_level ? this.next_level : "(none)");
+    return __curr_level_loader;
+}
+
 TilesetNode* tileset(TilemapNode* this) -> __engine_get_tileset(this);
+bool overlaps_solid(TilemapNode* this, float x1, float y1, float x2, float y2, int flags) -> __engine_overlaps_solid(this, x1, y1, x2, y2, flags);
+bool raycast(TilemapNode* this, float x, float y, float dir_x, float dir_y, float max_dist, int flags, int* hit_x, int* hit_y, float* dist) -> __engine_raycast(this, x, y, dir_x, dir_y, max_dist, flags, hit_x, hit_y, dist);
+float ground_probe(TilemapNode* this, float x, float y, float max_depth) -> __engine_ground_probe(this, x, y, max_depth);
+int query_radius(TilemapNode* this, float x, float y, float r, void* callback, void* data) -> __engine_query_radius(this, x, y, r, callback, data);
+int query_box(TilemapNode* this, float x1, float y1, float x2, float y2, void* callback, void* data) -> __engine_query_box(this, x1, y1, x2, y2, callback, data);
+int find_radius(TilemapNode* this, float x, float y, float r, EntityNode** out, int capacity) -> __engine_find_radius(this, x, y, r, out, capacity);
+int find_box(TilemapNode* this, float x1, float y1, float x2, float y2, EntityNode** out, int capacity) -> __engine_find_box(this, x1, y1, x2, y2, out, capacity);
 
 EntityNode* find(LevelRootNode* this, const char* name) -> __engine_find_entity(this, name);
 EntityNode* find(TilemapNode* this, const char* name) -> __engine_find_entity_on_tilemap(this, name);
+bool save(TilemapNode* this, const char* oob_tile_provider, const char* filename) -> __engine_save_level_asset(this, oob_tile_provider, filename);
 
 void update(LevelRootNode* this, float delta_time) -> __engine_update(this, delta_time);
 void render(LevelRootNode* this, float width, float height) -> __engine_render(this, width, height);
@@ -252,10 +333,15 @@ void start_frame(Window* this) -> __graphics_start_frame(this);
 void end_frame(Window* this) -> __graphics_end_frame(this);
 void post_process(Window* this, Shader* shader) -> __graphics_post_process(this, shader);
 void set_shader(Window* this, Shader* shader) -> __graphics_set_shader(this, shader);
+void set_uniform(Shader* this, const char* name, float x, float y, float z, float w) -> __graphics_set_uniform(this, name, x, y, z, w);
 void rect(Window* this, float x, float y, float w, float h, int color) -> __graphics_rect(this, x, y, w, h, color);
 void draw(Window* this, Texture* texture, float x, float y, float w, float h, float sx, float sy, float sw, float sh, int color) -> __graphics_draw(this, texture, x, y, w, h, sx, sy, sw, sh, color);
+void draw_text(Window* this, Texture* font, float x, float y, int scale, int color, const char* text) -> __graphics_text(this, font, x, y, scale, color, text);
+void draw_static_text(Window* this, Texture* font, float x, float y, int scale, int color, const char* text) -> __graphics_static_text(this, font, x, y, scale, color, text);
+void nine_slice(Window* this, Texture* texture, float sx, float sy, float sw, float sh, float inset, float x, float y, float w, float h, int color) -> __graphics_nine_slice(this, texture, sx, sy, sw, sh, inset, x, y, w, h, color);
 void blit(Window* this, Buffer* buffer, float x, float y, float w, float h, float sx, float sy, float sw, float sh, int color) -> __graphics_blit(this, buffer, x, y, w, h, sx, sy, sw, sh, color);
 Buffer* new_buffer(Window* this, int width, int height) -> __graphics_new_buffer(this, width, height);
+Buffer* frame_buffer(Window* this, int width, int height) -> __graphics_frame_buffer(this, width, height);
 void set_buffer(Window* this, Buffer* buffer) -> __graphics_set_buffer(this, buffer);
 void destroy(Buffer* this) -> __graphics_destroy_buffer(this);
 bool should_close(Graphics* this) -> __graphics_should_close();
@@ -369,6 +455,37 @@ NodeBuilder* tilemap(NodeBuilder* this, int width, int height, Tile(*oob_tile_pr
     return this;
 }
 
+NodeBuilder* tilemap_from_asset(NodeBuilder* this, const char* name) {
+    LevelAsset* asset = assets.get<LevelAsset>(name);
+    if (!asset) return this;
+    TilemapNode* node = this.curr_node;
+    __engine_load_level_tilemap(node, asset);
+    node.oob_tile_provider = __get_script_symbol(__engine_level_oob_provider(asset));
+    const char* func;
+    float x, y;
+    for (int i = 0; (func = __engine_level_spawn(asset, i, &x, &y)); i++) {
+        Node*(*spawn)(float x, float y) = __get_script_symbol(func);
+        if (spawn) node.attach(spawn(x, y));
+    }
+    return this;
+}
+
+// pages chunks of the level in and out around the camera instead of keeping the whole map resident,
+// budget is the number of resident 16x16 chunks and fallback_tile is returned for chunks that
+// aren't loaded yet (-1 asks the oob provider)
+NodeBuilder* stream_from_asset(NodeBuilder* this, const char* name, int budget, int fallback_tile, float focus_x, float focus_y) {
+    LevelAsset* asset = assets.get<LevelAsset>(name);
+    if (!asset) return this;
+    TilemapNode* node = this.curr_node;
+    node.oob_tile_provider = __get_script_symbol(__engine_level_oob_provider(asset));
+    __engine_stream_tilemap(node, asset, budget, fallback_tile, lambda(const char* func, float x, float y): Node* {
+        Node*(*spawn)(float x, float y) = __get_script_symbol(func);
+        if (!spawn) return nullptr;
+        return spawn(x, y);
+    }, focus_x, focus_y);
+    return this;
+}
+
 NodeBuilder* reopen(NodeBuilder* this) {
     if (this.curr_node.children_size == 0) return this;
     this.curr_node = this.curr_node.children[this.curr_node.children_size - 1];
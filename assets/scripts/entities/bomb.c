@@ -42,15 +42,10 @@ Node* entity_bomb(float x, float y) -> engine.open<EntityNode>()
                     explode_dust(tilemap, orig_x + x + 0.5, orig_y + y + 0.5, 0.3, 4);
                 }
             }
-            for (int i = 0; i < tilemap.node.children_size; i++) {
-                if (tilemap.node.children[i] && (int)tilemap.node.children[i].type == NodeType_Entity && tilemap.node.children[i] != entity) {
-                    EntityNode* e = tilemap.node.children[i];
-                    if (sqrtf((entity.pos_x - e.pos_x) * (entity.pos_x - e.pos_x) + (entity.pos_y - e.pos_y) * (entity.pos_y - e.pos_y)) < 2.5) {
-                        e.damage(entity);
-                        did_damage = true;
-                    }
-                }
-            }
+            // the bomb itself is always in range
+            if (tilemap.query_radius(entity.pos_x, entity.pos_y, 2.5, lambda(EntityNode* e, EntityNode* bomb): void {
+                if (e != bomb) e.damage(bomb);
+            }, entity) > 1) did_damage = true;
             if (!did_damage && *entity.prop<bool>("in_crate")) {
                 tilemap.set(*entity.prop<int>("crate_x"), *entity.prop<int>("crate_y"), 4);
                 tilemap.node.attach(entity_bomb(*entity.prop<int>("crate_x") + 0.5, *entity.prop<int>("crate_y") + 1));
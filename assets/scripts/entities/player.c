@@ -33,6 +33,15 @@ Node* entity_darkness_controller() -> engine.open<EntityNode>()
         entity.pos_y = player.pos_y;
     })
     .event<EntityTextureNode>(lambda entity_darkness_controller_texture(EntityNode* entity, TilemapNode* tilemap, float* srcx, float* srcy, float* srcw, float* srch, float* w, float* h, float* off_x, float* off_y): Texture* {
+        // backends without shaders load it as null and get the sprite instead
+        Shader* darkness = assets.get<Shader>("shaders/darkness.glsl");
+        if (darkness) {
+            float x, y;
+            entity.screen_pos(&x, &y);
+            darkness.set_uniform("light", x, y - 6, 48, 96);
+            gfx.main().post_process(darkness);
+            return nullptr;
+        }
         *off_y = 280;
         return assets.get<Texture>("images/darkness.png");
     })
@@ -67,7 +76,7 @@ Node* entity_player(float x, float y) -> engine.open<EntityNode>()
                 }
                 else {
                     LevelRootNode* level = entity.node.parent.parent;
-                    __curr_level_loader = level.next_level;
+                    __curr_level_loader = level.next_loader();
                     if (engine.create_transition(engine.reload, 60, Direction_Left))
                         sound_transition().play_oneshot();
                 }
@@ -202,22 +211,13 @@ Node* entity_player(float x, float y) -> engine.open<EntityNode>()
                 };
                 break_crate(entity, 0, 0.5);
                 break_crate(entity, *entity.prop<bool>("facing_left") ? -0.5 : 0.5, -0.1);
-                for (int i = 0; i < tilemap.node.children_size; i++) {
-                    if (tilemap.node.children[i] && (int)tilemap.node.children[i].type == NodeType_Entity && tilemap.node.children[i] != entity) {
-                        EntityNode* scratchee /* this fuckass name lmfao */ = tilemap.node.children[i];
-                        if (
-                            ( *entity.prop<bool>("facing_left") && scratchee.pos_x < entity.pos_x) ||
-                            (!*entity.prop<bool>("facing_left") && scratchee.pos_x > entity.pos_x)
-                        ) {
-                            float max_dist = fmax(fabsf(entity.vel_x) * 15, 1.75);
-                            float dist = sqrtf(
-                                (scratchee.pos_x - entity.pos_x) * (scratchee.pos_x - entity.pos_x) +
-                                (scratchee.pos_y - entity.pos_y) * (scratchee.pos_y - entity.pos_y)
-                            );
-                            if (dist < max_dist) scratchee.damage(entity);
-                        }
-                    }
-                }
+                tilemap.query_radius(entity.pos_x, entity.pos_y, fmax(fabsf(entity.vel_x) * 15, 1.75), lambda(EntityNode* scratchee, EntityNode* entity): void {
+                    if (scratchee == entity) return;
+                    if (
+                        ( *entity.prop<bool>("facing_left") && scratchee.pos_x < entity.pos_x) ||
+                        (!*entity.prop<bool>("facing_left") && scratchee.pos_x > entity.pos_x)
+                    ) scratchee.damage(entity);
+                }, entity);
                 *scratch_timer = 12;
             }
             if (tilemap.find("wrap_controller")) {
@@ -1,4 +1,7 @@
 #depends "scripts/levels/title.c"
+#depends "scripts/editor.c"
+#depends "scripts/entities/player.c"
+#depends "scripts/tilesets/grass.c"
 
 #depends "scripts/engine.c"
 #depends "scripts/ui.c"
@@ -9,6 +12,7 @@
 #define KB_NUMBER(n) ((n) - '1' + 30)
 #define KB_TAB 43
 #define KB_SPACE 44
+#define KB_F12 69
 #define KB_CTRL 224
 #define KB_SHIFT 225
 
@@ -30,6 +34,7 @@ void entry_point() {
     input.add("jump", KB_SPACE);
     input.add("shift", KB_SHIFT);
     input.add("ctrl", KB_CTRL);
+    input.add("capture", KB_F12);
 
     input.add("editor_tile_picker", KB_LETTER('E'));
     input.add("editor_obj_picker", KB_LETTER('Q'));
@@ -88,13 +93,14 @@ void entry_point() {
 
     uint64_t last_micros = engine.get_micros();
     while (!gfx.should_close()) {
+        if (engine.apply_reloads()) last_micros = engine.get_micros(); // don't count the compile as game time
         uint64_t curr_micros = engine.get_micros();
         float delta_time = (curr_micros - last_micros) / 1000000.f * 60;
         last_micros = curr_micros;
         if (delta_time > 60) delta_time = 60;
 
         w.start_frame();
-        Buffer* buf = w.new_buffer(384, 256);
+        Buffer* buf = w.frame_buffer(384, 256);
         w.set_buffer(buf);
 
         input.update();
@@ -126,14 +132,17 @@ void entry_point() {
             }
             ui_hud();
         }
+        if (engine.reload_pending()) ui_label(2, 246, 0xFFFF00FF, "reloading..."); // also the frame shown while the reload compiles
+        if (input.pressed("capture")) engine.toggle_capture();
+        engine.capture_frame(w, buf, 384, 256);
 
         w.set_buffer(nullptr);
         w.blit(buf, offset_x * scale, offset_y * scale, 384 * scale, 256 * scale, 0, 0, 384, 256, 0xFFFFFFFF);
         w.end_frame();
-
-        buf.destroy();
+        engine.pace_frame(w);
 
         engine.check_watched_files();
+        engine.compile_prefetched();
     }
     w.close();
 }
@@ -1,7 +1,10 @@
-#depends "scripts/levels/level2.c"
+#depends "scripts/engine.c"
+#depends "scripts/tilesets/grass.c"
+#depends "scripts/decorator.c"
+#depends "scripts/decorators/foliage.c"
 
 Node* level1() -> engine.open<LevelRootNode>()
-    .prop<Level>(level2) // next_level
+    .prop<const char*>("level2") // next_level
     .exec(grass_bg)
     .open<TilemapNode>()
         .attach(tileset_grass())
@@ -11,59 +14,6 @@ Node* level1() -> engine.open<LevelRootNode>()
         .prop<float>(0.0f) // scroll_offset_y
         .prop<float>(1.0f) // scroll_speed_x
         .prop<float>(1.0f) // scroll_speed_y
-        .tilemap(214, 16, grass_oob_provider, (Tile[]){
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,5,5,5,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,5,5,5,5,5,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,1,1,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,6,6,7,7,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,6,6,5,5,6,6,7,7,7,7,7,7,7,6,6,7,7,7,7,7,7,7,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,7,7,7,7,7,7,7,6,6,1,1,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,0,5,5,0,0,0,0,0,0,0,0,0,0,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,6,6,0,6,6,4,4,4,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,6,6,5,5,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,5,5,5,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,7,7,7,7,6,6,0,0,0,0,0,0,0,6,6,1,1,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,5,0,0,5,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,4,4,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,0,0,0,6,6,0,0,0,0,0,6,6,1,1,1,1,7,7,7,7,7,7,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,6,6,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,1,1,1,0,0,0,0,0,7,7,7,6,6,0,0,0,0,0,6,6,0,6,6,0,6,6,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,1,1,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,6,6,0,0,0,0,0,0,0,0,0,6,6,0,4,4,0,6,6,0,5,5,5,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,7,7,6,6,0,0,0,0,4,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,0,0,0,0,6,6,0,5,5,5,0,6,6,7,7,7,7,7,7,7,7,6,6,1,1,1,1,6,6,6,6,6,6,6,6,6,6,7,7,7,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,4,6,6,0,0,0,7,7,6,6,7,6,6,7,6,6,7,7,7,7,7,6,6,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,1,1,1,1,1,
-            1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,6,6,0,0,5,5,5,5,5,0,0,6,6,1,1,1,7,6,6,7,7,7,7,7,0,0,0,0,0,4,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,0,0,6,6,1,1,1,1,1,1,1,1,0,0,0,0,0,0,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,6,6,0,0,0,0,1,1,1,1,1,1,1,1,1,6,6,0,0,0,0,4,4,0,0,0,0,0,0,6,6,1,1,1,1,6,6,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,0,0,0,0,6,6,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,6,6,5,5,5,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,6,6,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,6,6,7,7,7,7,7,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,6,6,0,1,1,1,1,1,1,1,1,1,1,1,1,6,6,0,0,0,4,4,4,4,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,7,7,7,7,7,7,7,7,7,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-        })
-        .attach(entity_level_start(2.5f, 12.0f))
-        .attach(entity_level_end(211.5f, 7.0f))
-        .attach(entity_mouse(194.0f, 8.0f))
-        .attach(entity_coin(33.5f, 11.0f))
-        .attach(entity_coin(34.5f, 11.0f))
-        .attach(entity_mouse(47.5f, 13.0f))
-        .attach(entity_coin(52.5f, 12.0f))
-        .attach(entity_coin(53.5f, 12.0f))
-        .attach(entity_coin(53.5f, 11.0f))
-        .attach(entity_heart(67.5f, 13.0f))
-        .attach(entity_mouse(77.0f, 11.0f))
-        .attach(entity_mouse(75.5f, 11.0f))
-        .attach(entity_coin(84.5f, 12.0f))
-        .attach(entity_mouse(106.0f, 9.0f))
-        .attach(entity_mouse(109.0f, 6.0f))
-        .attach(entity_heart(112.5f, 10.0f))
-        .attach(entity_coin(113.5f, 10.0f))
-        .attach(entity_coin(114.5f, 10.0f))
-        .attach(entity_mouse(135.0f, 11.0f))
-        .attach(entity_mouse(133.5f, 11.0f))
-        .attach(entity_mouse(160.0f, 6.0f))
-        .attach(entity_mouse(157.0f, 8.0f))
-        .attach(entity_coin(172.5f, 13.0f))
-        .attach(entity_coin(171.5f, 12.0f))
-        .attach(entity_mouse(183.5f, 8.0f))
-        .attach(entity_mouse(192.5f, 8.0f))
-        .attach(entity_mouse(194.0f, 4.0f))
-        .attach(entity_mouse(192.5f, 4.0f))
-        .attach(entity_mouse(209.0f, 7.0f))
-        .attach(entity_mouse(207.5f, 7.0f))
-        .attach(entity_mouse(206.0f, 8.0f))
-        .attach(entity_key_a(1.5f, 10.0f))
-        .attach(entity_key_d(3.5f, 10.0f))
-        .attach(entity_key_l(34.0f, 9.0f))
-        .attach(entity_key_space(15.0f, 13.0f))
-        .attach(entity_player(2.5f, 12.0f))
+        .tilemap_from_asset("levels/level1.lvl")
     .close().decorate(foliage_decorator)
 .build();
@@ -1,7 +1,10 @@
-#depends "scripts/levels/level3.c"
+#depends "scripts/engine.c"
+#depends "scripts/tilesets/grass.c"
+#depends "scripts/decorator.c"
+#depends "scripts/decorators/foliage.c"
 
 Node* level2() -> engine.open<LevelRootNode>()
-    .prop<Level>(level3) // next_level
+    .prop<const char*>("level3") // next_level
     .exec(grass_bg)
     .open<TilemapNode>()
         .attach(tileset_grass())
@@ -11,61 +14,6 @@ Node* level2() -> engine.open<LevelRootNode>()
         .prop<float>(0.0f) // scroll_offset_y
         .prop<float>(1.0f) // scroll_speed_x
         .prop<float>(1.0f) // scroll_speed_y
-        .tilemap(171, 16, grass_oob_provider, (Tile[]){
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,5,5,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,5,0,0,5,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,7,7,6,6,7,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,7,7,7,7,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,4,0,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,4,6,6,1,1,1,1,1,0,0,0,4,0,6,6,5,5,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,4,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,6,6,6,6,0,0,6,6,0,0,0,0,0,0,0,0,6,6,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,4,4,6,6,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,7,7,7,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,6,6,7,6,6,6,6,0,0,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,7,7,7,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,6,6,6,6,6,6,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,0,6,6,0,0,1,1,1,1,0,0,0,0,0,1,1,1,1,
-            0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,7,7,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,1,1,0,0,0,0,0,6,6,5,5,5,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,6,6,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,6,6,6,6,8,8,0,0,0,6,6,0,0,0,6,6,1,1,1,1,1,6,6,1,1,1,1,1,1,0,0,0,0,0,1,1,1,1,
-            0,0,0,0,0,9,0,6,6,7,7,7,7,6,6,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,6,6,7,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,4,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,8,8,6,6,8,8,0,0,0,6,6,0,0,0,6,6,1,1,1,1,1,6,6,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,
-            0,0,0,0,0,0,0,6,6,4,0,0,0,6,6,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,0,0,0,0,0,0,6,6,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,0,0,0,6,6,6,6,6,6,1,1,1,1,1,1,1,6,6,0,0,0,6,6,6,6,6,6,8,8,8,8,8,8,0,0,7,6,6,7,7,7,6,6,0,1,1,1,0,8,8,4,4,4,4,0,0,0,0,0,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,6,6,1,1,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,6,6,0,4,0,8,8,6,6,8,8,8,8,8,8,8,8,0,0,0,6,6,0,0,0,6,6,4,4,4,4,0,8,8,4,4,4,4,4,0,0,0,0,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,6,6,1,1,1,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,6,6,4,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,8,8,8,8,8,8,8,8,8,8,6,6,0,0,0,6,6,0,9,0,0,0,4,4,4,4,4,6,6,1,1,1,4,4,4,4,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,7,7,7,7,7,7,7,6,6,7,7,7,7,6,6,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,8,8,8,8,8,8,6,6,6,6,6,6,0,0,0,6,6,7,7,7,7,7,7,7,7,7,7,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,6,6,6,6,6,6,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-        })
-        .attach(entity_level_start(2.0f, 12.0f))
-        .attach(entity_level_end(2.0f, 12.0f))
-        .attach(entity_purple_coin(9.5f, 12.0f))
-        .attach(entity_mouse(66.5f, 13.0f))
-        .attach(entity_coin(18.5f, 8.0f))
-        .attach(entity_coin(19.5f, 8.0f))
-        .attach(entity_coin(19.5f, 7.0f))
-        .attach(entity_mouse(19.0f, 4.0f))
-        .attach(entity_coin(30.5f, 7.0f))
-        .attach(entity_mouse(46.5f, 8.0f))
-        .attach(entity_mouse(44.0f, 8.0f))
-        .attach(entity_mouse(128.5f, 15.0f))
-        .attach(entity_mouse(64.5f, 13.0f))
-        .attach(entity_mouse(62.5f, 13.0f))
-        .attach(entity_heart(81.5f, 11.0f))
-        .attach(entity_mouse(81.0f, 9.0f))
-        .attach(entity_purple_coin(82.5f, 14.0f))
-        .attach(entity_mouse(96.5f, 9.0f))
-        .attach(entity_mouse(94.5f, 9.0f))
-        .attach(entity_mouse(101.0f, 14.0f))
-        .attach(entity_mouse(99.5f, 14.0f))
-        .attach(entity_mouse(98.0f, 14.0f))
-        .attach(entity_mouse(96.5f, 14.0f))
-        .attach(entity_mouse(119.0f, 9.0f))
-        .attach(entity_coin(109.5f, 7.0f))
-        .attach(entity_purple_coin(125.5f, 13.0f))
-        .attach(entity_mouse(138.0f, 4.0f))
-        .attach(entity_mouse(130.5f, 15.0f))
-        .attach(entity_purple_coin(157.5f, 13.0f))
-        .attach(entity_coin(150.5f, 13.0f))
-        .attach(entity_coin(151.5f, 14.0f))
-        .attach(entity_coin(159.5f, 12.0f))
-        .attach(entity_coin(156.5f, 12.0f))
-        .attach(entity_coin(160.5f, 14.0f))
-        .attach(entity_coin(162.5f, 14.0f))
-        .attach(entity_heart(149.5f, 13.0f))
-        .attach(entity_coin(169.5f, 6.0f))
-        .attach(entity_player(2.0f, 12.0f))
+        .tilemap_from_asset("levels/level2.lvl")
     .close().decorate(foliage_decorator)
 .build();
\ No newline at end of file
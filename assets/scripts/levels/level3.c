@@ -1,7 +1,8 @@
-#depends "scripts/levels/level4.c"
+#depends "scripts/engine.c"
+#depends "scripts/tilesets/upside_down.c"
 
 Node* level3() -> engine.open<LevelRootNode>()
-    .prop<Level>(level4) // next_level
+    .prop<const char*>("level4") // next_level
     .exec(upside_down_bg)
     .open<TilemapNode>()
         .attach(tileset_upside_down())
@@ -11,61 +12,6 @@ Node* level3() -> engine.open<LevelRootNode>()
         .prop<float>(0.0f) // scroll_offset_y
         .prop<float>(1.0f) // scroll_speed_x
         .prop<float>(1.0f) // scroll_speed_y
-        .tilemap(176, 16, grass_oob_provider, (Tile[]){
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,6,6,0,1,1,1,1,0,0,0,5,5,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,6,6,0,0,0,0,0,8,8,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,5,0,0,5,0,0,0,0,0,0,1,1,1,1,1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,6,6,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,
-            0,0,0,0,0,0,0,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,
-            0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,6,6,0,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,7,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,0,0,0,0,8,8,0,0,0,0,6,6,0,0,6,6,0,0,6,6,0,0,0,0,8,8,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,6,6,0,0,0,6,6,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,10,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,7,7,7,6,6,0,0,0,0,0,0,0,6,6,6,6,0,0,0,0,0,0,0,0,0,
-            0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,6,6,0,0,0,0,6,6,0,0,0,0,6,6,7,7,6,6,7,7,6,6,0,0,0,0,8,8,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,6,6,5,5,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,5,5,5,5,5,0,6,6,0,0,0,0,0,0,0,8,8,0,0,7,7,6,6,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,7,0,0,10,6,6,0,0,0,0,6,6,0,0,0,0,0,1,1,6,6,6,6,6,6,0,6,6,0,0,0,0,
-            0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,6,6,5,5,5,5,6,6,0,4,4,0,6,6,0,0,6,6,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,6,6,6,6,1,1,1,1,0,0,0,0,0,10,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,7,7,7,7,6,6,0,0,0,0,8,8,0,0,0,0,1,1,1,6,6,6,6,6,6,7,6,6,6,6,6,6,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,6,6,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,6,6,6,6,7,7,7,7,7,7,7,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,9,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,8,8,0,0,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,
-            0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,7,7,7,7,7,7,0,0,6,6,7,7,7,7,7,7,7,7,7,6,6,6,6,1,1,1,1,1,1,1,1,0,10,0,0,0,0,0,0,10,6,6,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,7,7,7,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,7,7,7,6,6,0,10,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,
-            6,6,6,6,6,6,0,0,0,0,0,0,0,0,6,6,6,6,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,6,6,1,1,6,6,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,7,7,7,7,7,7,7,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,7,7,7,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,7,7,7,7,0,0,0,8,8,0,0,0,0,6,6,0,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,6,6,6,6,
-            6,6,6,6,6,6,7,7,7,7,7,7,7,7,6,6,6,6,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,6,6,4,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,6,6,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            6,6,6,6,6,6,0,0,0,0,0,0,0,0,6,6,6,6,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,0,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,4,4,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,7,7,7,7,7,6,6,0,0,0,0,6,6,7,0,0,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,10,8,8,0,4,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-            6,6,6,6,6,6,0,0,0,0,0,0,0,0,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,7,7,7,7,7,7,7,7,7,7,7,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-        })
-        .attach(entity_level_start(3.0f, 12.0f))
-        .attach(entity_level_end(174.0f, 9.0f))
-        .attach(entity_mouse(15.0f, 8.0f))
-        .attach(entity_mouse(61.5f, 11.0f))
-        .attach(entity_mouse(60.0f, 11.0f))
-        .attach(entity_coin(71.5f, 15.0f))
-        .attach(entity_mouse(58.5f, 11.0f))
-        .attach(entity_coin(25.5f, 10.0f))
-        .attach(entity_coin(26.5f, 10.0f))
-        .attach(entity_turtle(75.0f, 10.0f))
-        .attach(entity_coin(72.5f, 15.0f))
-        .attach(entity_mouse(82.5f, 12.0f))
-        .attach(entity_mouse(81.5f, 12.0f))
-        .attach(entity_mouse(80.5f, 12.0f))
-        .attach(entity_mouse(79.5f, 12.0f))
-        .attach(entity_mouse(78.5f, 12.0f))
-        .attach(entity_mouse(77.5f, 12.0f))
-        .attach(entity_mouse(94.5f, 10.0f))
-        .attach(entity_heart(71.5f, 14.0f))
-        .attach(entity_mouse(93.0f, 10.0f))
-        .attach(entity_mouse(103.0f, 12.0f))
-        .attach(entity_mouse(101.5f, 12.0f))
-        .attach(entity_turtle(115.0f, 8.0f))
-        .attach(entity_mouse(134.5f, 8.0f))
-        .attach(entity_mouse(133.0f, 8.0f))
-        .attach(entity_mouse(131.5f, 8.0f))
-        .attach(entity_mouse(130.0f, 8.0f))
-        .attach(entity_mouse(136.0f, 8.0f))
-        .attach(entity_mouse(137.5f, 8.0f))
-        .attach(entity_mouse(139.0f, 8.0f))
-        .attach(entity_mouse(140.5f, 8.0f))
-        .attach(entity_mouse(142.0f, 8.0f))
-        .attach(entity_mouse(143.5f, 8.0f))
-        .attach(entity_mouse(145.0f, 8.0f))
-        .attach(entity_mouse(165.0f, 6.0f))
-        .attach(entity_heart(157.5f, 15.0f))
-        .attach(entity_key_l(73.5f, 9.0f))
-        .attach(entity_player(3.0f, 12.0f))
+        .tilemap_from_asset("levels/level3.lvl")
     .close()
 .build();
@@ -1,7 +1,9 @@
-#depends "scripts/levels/level5.c"
+#depends "scripts/engine.c"
+#depends "scripts/tilesets/grass.c"
+#depends "scripts/entities/player.c"
 
 Node* level4() -> engine.open<LevelRootNode>()
-    .prop<Level>(level5) // next_level
+    .prop<const char*>("level5") // next_level
     .exec(grass_bg)
     .open<TilemapNode>()
         .attach(tileset_grass())
@@ -11,53 +13,7 @@ Node* level4() -> engine.open<LevelRootNode>()
         .prop<float>(0.0f) // scroll_offset_y
         .prop<float>(1.0f) // scroll_speed_x
         .prop<float>(1.0f) // scroll_speed_y
-        .tilemap(240, 16, grass_oob_provider, (Tile[]){
-            1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,1,1,1,0,0,0,0,6,6,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,0,0,6,6,0,0,0,0,0,6,6,6,6,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,6,6,6,6,6,6,6,6,6,6,6,6,8,8,6,6,6,6,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,0,0,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,6,6,0,0,0,0,0,0,0,0,0,0,7,6,6,0,0,0,6,6,7,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,6,6,6,6,6,6,6,6,6,6,6,6,8,8,6,6,6,6,0,0,6,6,0,0,0,0,0,0,0,0,0,7,7,7,7,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,6,6,0,5,5,5,5,5,5,5,5,5,0,6,6,0,0,0,6,6,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,0,0,0,0,7,7,6,6,8,8,8,8,6,6,6,6,8,8,8,8,8,8,8,8,6,6,0,0,0,0,0,0,1,1,1,1,1,1,1,1,4,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,8,8,6,6,6,6,6,6,6,6,6,6,8,8,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,7,7,7,7,7,6,6,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,8,8,8,8,6,6,6,6,8,8,8,8,8,8,8,8,6,6,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,8,8,1,1,1,1,1,1,1,1,6,6,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,8,8,8,8,6,6,6,6,6,6,6,6,8,8,8,8,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,6,6,7,7,7,7,7,7,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,8,8,8,8,6,6,8,8,8,8,8,8,8,8,8,8,8,8,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,8,8,1,1,1,1,1,1,1,1,6,6,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,8,8,8,8,8,8,6,6,6,6,6,6,8,8,6,6,0,0,0,0,6,6,7,7,7,7,6,6,7,7,7,7,7,7,7,6,6,0,0,8,8,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,7,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,4,0,6,6,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,0,0,8,8,8,8,8,8,8,8,8,8,6,6,6,6,7,7,6,6,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,6,6,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,8,8,0,0,8,8,0,0,8,8,5,5,8,8,5,5,8,8,0,0,8,8,0,0,8,8,8,8,8,8,8,8,8,8,8,8,6,6,8,8,6,6,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,8,8,0,0,8,8,0,0,0,0,0,0,0,6,6,7,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,6,6,8,8,6,6,8,8,8,8,8,8,8,8,8,8,8,8,8,8,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,8,8,0,0,8,8,5,5,8,8,0,0,8,8,0,0,8,8,5,5,8,8,0,0,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,6,6,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,8,8,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,11,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,8,8,6,6,8,8,8,8,8,8,8,8,8,8,8,8,8,8,11,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,8,8,0,0,0,0,0,0,0,0,8,8,5,5,8,8,0,0,8,8,0,11,8,8,11,0,8,8,0,0,8,8,5,5,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,8,6,6,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,0,6,6,7,7,7,7,7,7,7,7,7,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,0,0,11,0,0,0,0,0,0,0,0,0,0,0,6,6,8,8,0,0,0,0,0,0,0,0,8,8,0,0,8,8,0,0,8,8,0,0,6,6,0,0,8,8,0,0,8,8,0,0,8,8,8,8,8,8,8,8,8,8,8,8,6,6,8,8,6,6,0,0,0,0,8,8,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,7,7,6,6,0,0,0,0,0,0,0,8,8,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,7,7,7,7,7,7,0,0,0,0,0,11,0,0,0,0,0,0,0,11,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,0,0,0,0,0,6,6,6,6,0,0,0,0,0,0,0,0,8,8,0,11,8,8,11,0,6,6,0,0,6,6,0,0,6,6,0,11,8,8,11,0,8,8,8,8,8,8,8,8,8,8,6,6,6,6,8,8,6,6,0,0,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,1,1,1,1,1,1,1,0,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,0,0,0,0,0,0,0,0,0,0,0,0,10,0,6,6,0,0,0,0,0,0,0,0,8,8,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,8,8,8,8,8,8,8,8,6,6,6,6,6,6,8,8,6,6,7,7,7,7,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,8,8,0,0,6,6,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,0,0,0,0,0,0,0,0,5,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,0,0,0,6,6,0,0,6,6,0,0,0,0,0,0,0,8,8,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,8,8,8,8,6,6,6,6,6,6,6,6,8,8,6,6,5,5,5,5,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,8,8,0,0,6,6,7,7,7,7,7,7,7,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,0,0,0,5,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,0,0,6,6,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,6,6,6,6,6,6,6,6,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,8,8,6,6,6,6,6,6,6,6,6,6,8,8,6,6,5,5,5,5,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,0,0,0,5,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,1,1,0,0,0,0,0,6,6,0,0,0,6,6,0,0,0,0,0,7,7,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,7,7,7,7,7,7,0,6,6,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,6,6,6,6,6,6,6,6,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,6,6,6,6,6,6,6,6,6,6,6,6,8,8,8,8,0,0,0,0,6,6,0,0,0,0,6,6,7,7,7,7,7,7,7,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-            1,1,1,1,1,1,1,1,1,1,0,0,5,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,6,6,1,1,1,0,0,0,0,6,6,0,0,0,6,6,0,0,0,0,0,0,0,6,6,0,0,0,0,0,0,0,0,6,6,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,0,0,0,0,0,6,6,6,6,8,8,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,6,1,1,1,1,1,1,1,1,1,1,1,1,0,0,6,6,5,5,5,5,5,5,5,5,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,0,0,6,6,6,6,6,6,6,6,6,6,6,6,6,6,8,8,6,6,6,6,0,0,6,6,0,0,0,0,6,6,0,0,0,0,0,0,0,6,6,6,6,6,6,0,0,0,0,0,0,0,6,6,0,6,6,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-        })
+        .tilemap_from_asset("levels/level4.lvl")
         .attach(entity_wrap_controller())
-        .attach(entity_level_start(3.5f, 13.0f))
-        .attach(entity_level_end(223.5f, 8.0f))
-        .attach(entity_mouse(110.0f, 9.0f))
-        .attach(entity_coin(57.5f, 10.0f))
-        .attach(entity_mouse(75.0f, 11.0f))
-        .attach(entity_mouse(73.5f, 11.0f))
-        .attach(entity_turtle(112.0f, 10.0f))
-        .attach(entity_mouse(108.5f, 9.0f))
-        .attach(entity_mouse(107.0f, 9.0f))
-        .attach(entity_mouse(105.5f, 9.0f))
-        .attach(entity_mouse(150.0f, 9.0f))
-        .attach(entity_mouse(136.5f, 13.0f))
-        .attach(entity_mouse(135.0f, 13.0f))
-        .attach(entity_mouse(133.5f, 13.0f))
-        .attach(entity_mouse(132.0f, 13.0f))
-        .attach(entity_mouse(174.5f, 9.0f))
-        .attach(entity_heart(125.5f, 3.0f))
-        .attach(entity_mouse(142.0f, 11.0f))
-        .attach(entity_mouse(158.0f, 11.0f))
-        .attach(entity_turtle(188.0f, 4.0f))
-        .attach(entity_mouse(173.0f, 9.0f))
-        .attach(entity_mouse(171.5f, 10.0f))
-        .attach(entity_turtle(209.5f, 12.0f))
-        .attach(entity_turtle(208.0f, 12.0f))
-        .attach(entity_turtle(206.5f, 12.0f))
-        .attach(entity_mouse(213.5f, 6.0f))
-        .attach(entity_heart(89.5f, 6.0f))
-        .attach(entity_mouse(222.5f, 8.0f))
-        .attach(entity_player(3.5f, 13.0f))
     .close()
 .build();
\ No newline at end of file
@@ -38,13 +38,17 @@ void tileset_grass_data(NodeBuilder* builder) -> builder
                 SE = (1 << 7),
             };
 
-            if (tilemap.get(x, y - 1) == 6) {
+            // 3x3 neighbourhood in one call, runs for every visible grass tile each frame
+            uint8_t n[9];
+            tilemap.get_tiles(x - 1, y - 1, x + 2, y + 2, n);
+
+            if (n[1] == 6) {
                 int offset = 0;
                 while (tilemap.get(x - ++offset, y - 1) == 6);
                 if (offset % 2 == 1) return TILE(0, 3);
                 return TILE(1, 3);
             }
-            if (tilemap.get(x, y + 1) == 6) {
+            if (n[7] == 6) {
                 int offset = 0;
                 while (tilemap.get(x - ++offset, y + 1) == 6);
                 if (offset % 2 == 1) return TILE(0, 4);
@@ -52,14 +56,14 @@ void tileset_grass_data(NodeBuilder* builder) -> builder
             }
 
             int mask = 0;
-            if (tilemap.get(x + 0, y - 1) == 1) mask |= N;
-            if (tilemap.get(x - 1, y + 0) == 1) mask |= W;
-            if (tilemap.get(x + 0, y + 1) == 1) mask |= S;
-            if (tilemap.get(x + 1, y + 0) == 1) mask |= E;
-            if (tilemap.get(x - 1, y - 1) == 1) mask |= NW;
-            if (tilemap.get(x - 1, y + 1) == 1) mask |= SW;
-            if (tilemap.get(x + 1, y - 1) == 1) mask |= NE;
-            if (tilemap.get(x + 1, y + 1) == 1) mask |= SE;
+            if (n[1] == 1) mask |= N;
+            if (n[3] == 1) mask |= W;
+            if (n[7] == 1) mask |= S;
+            if (n[5] == 1) mask |= E;
+            if (n[0] == 1) mask |= NW;
+            if (n[6] == 1) mask |= SW;
+            if (n[2] == 1) mask |= NE;
+            if (n[8] == 1) mask |= SE;
 
             if (!(mask & N) || !(mask & W)) mask &= ~NW;
             if (!(mask & S) || !(mask & W)) mask &= ~SW;
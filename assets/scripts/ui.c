@@ -4,41 +4,17 @@ bool ui_hovering(int x, int y, int w, int h) -> input.mouse_x() >= x && input.mo
 
 bool ui_container(int x, int y, int w, int h, int color) {
     Texture* bg = assets.get<Texture>("images/hud/container.png");
-    gfx.main().draw(bg, x,         y,         3,     3,     0,  0, 3, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + w - 3, y,         3,     3,     4,  0, 3, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x,         y + h - 3, 3,     3,     0,  4, 3, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + w - 3, y + h - 3, 3,     3,     4,  4, 3, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + 3,     y,         w - 6, 3,     3,  0, 1, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + 3,     y + h - 3, w - 6, 3,     3,  4, 1, 3, 0xFFFFFFFF);
-    gfx.main().draw(bg, x,         y + 3,     3,     h - 6, 0,  3, 3, 1, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + w - 3, y + 3,     3,     h - 6, 4,  3, 3, 1, 0xFFFFFFFF);
-    gfx.main().draw(bg, x + 3,     y + 3,     w - 6, h - 6, 4,  4, 1, 1, 0xFFFFFFFF);
-    gfx.main().draw(bg, x,         y,         3,     3,     7,  0, 3, 3, color);
-    gfx.main().draw(bg, x + w - 3, y,         3,     3,     11, 0, 3, 3, color);
-    gfx.main().draw(bg, x,         y + h - 3, 3,     3,     7,  4, 3, 3, color);
-    gfx.main().draw(bg, x + w - 3, y + h - 3, 3,     3,     11, 4, 3, 3, color);
-    gfx.main().draw(bg, x + 3,     y,         w - 6, 3,     10, 0, 1, 3, color);
-    gfx.main().draw(bg, x + 3,     y + h - 3, w - 6, 3,     10, 4, 1, 3, color);
-    gfx.main().draw(bg, x,         y + 3,     3,     h - 6, 7,  3, 3, 1, color);
-    gfx.main().draw(bg, x + w - 3, y + 3,     3,     h - 6, 11, 3, 3, 1, color);
-    gfx.main().draw(bg, x + 3,     y + 3,     w - 6, h - 6, 10, 3, 1, 1, color);
+    gfx.main().nine_slice(bg, 0, 0, 7, 7, 3, x, y, w, h, 0xFFFFFFFF);
+    gfx.main().nine_slice(bg, 7, 0, 7, 7, 3, x, y, w, h, color);
     return ui_hovering(x, y, w, h);
 }
 
-void ui_scaled_label(int x, int y, int color, int scale, const char* text) {
-    Texture* font = assets.get<Texture>("images/hud/font.png");
-    char c;
-    while ((c = *text++)) {
-        int src_x = c % 16;
-        int src_y = c / 16 - 2;
-        gfx.main().draw(font, x, y, 6 * scale, 8 * scale, src_x * 6, src_y * 8, 6, 8, color);
-        x += 6 * scale;
-    }
-}
+void ui_scaled_label(int x, int y, int color, int scale, const char* text) -> gfx.main().draw_text(assets.get<Texture>("images/hud/font.png"), x, y, scale, color, text);
+void ui_label(int x, int y, int color, const char* text) -> ui_scaled_label(x, y, color, 1, text);
 
-void ui_label(int x, int y, int color, const char* text) {
-    ui_scaled_label(x, y, color, 1, text);
-}
+// for text that stays the same across frames, drawn once into a cached buffer
+void ui_scaled_static_label(int x, int y, int color, int scale, const char* text) -> gfx.main().draw_static_text(assets.get<Texture>("images/hud/font.png"), x, y, scale, color, text);
+void ui_static_label(int x, int y, int color, const char* text) -> ui_scaled_static_label(x, y, color, 1, text);
 
 bool ui_button(int x, int y, int w, int h, bool disabled, const char* text) {
     bool clicked = false;
@@ -52,7 +28,7 @@ bool ui_button(int x, int y, int w, int h, bool disabled, const char* text) {
     int text_len = strlen(text) * 6;
     x += (w - text_len) / 2;
     y += (h - 8) / 2;
-    ui_label(x, y, 0x1F1F1FFF, text);
+    ui_static_label(x, y, 0x1F1F1FFF, text);
     return clicked;
 }
 
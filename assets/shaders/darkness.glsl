@@ -0,0 +1,17 @@
+#version 330 core
+
+// everything outside a circle of light around a point fades to black.
+// light is x and y in pixels of the target, then the radius where it starts to fade and where it's fully dark.
+
+in vec2 uv;
+in vec4 tint;
+uniform sampler2D image;
+uniform vec4 size;
+uniform vec4 light;
+out vec4 out_color;
+
+void main() {
+    vec4 color = texture(image, uv) * tint;
+    float dist = distance(uv * size.xy, light.xy);
+    out_color = vec4(color.rgb * (1.0 - smoothstep(light.z, light.w, dist)), color.a);
+}
@@ -0,0 +1,104 @@
+#include "capture.h"
+#include "io/platform.h"
+#include "stb_image_write.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CAPTURE_DIR "captures"
+#define CAPTURE_SLOTS 8 // frames waiting for the encoder, further frames are dropped
+
+typedef struct {
+    Color* pixels;
+    int width, height;
+    int frame;
+} CaptureSlot;
+
+static CaptureSlot slots[CAPTURE_SLOTS];
+static int first_ready, num_ready;
+static int num_frames, num_written, num_dropped;
+static bool capturing, encoder_started, finishing;
+static pthread_t encoder;
+static pthread_mutex_t capture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t capture_cond = PTHREAD_COND_INITIALIZER;
+
+// frames are composed over black on screen, so flatten them the same way instead of writing transparent pixels
+static void encode_slot(CaptureSlot* slot) {
+    uint8_t* bytes = (uint8_t*)slot->pixels;
+    for (int i = 0; i < slot->width * slot->height * 4; i += 4) {
+        for (int c = 0; c < 3; c++) bytes[i + c] = bytes[i + c] * bytes[i + 3] / 255;
+        bytes[i + 3] = 255;
+    }
+    char path[64];
+    snprintf(path, sizeof(path), CAPTURE_DIR "/frame_%06d.png", slot->frame);
+    if (!stbi_write_png(path, slot->width, slot->height, 4, slot->pixels, slot->width * 4)) fprintf(stderr, "Failed to write %s\n", path);
+}
+
+static void* capture_encoder(void* arg) {
+    pthread_mutex_lock(&capture_mutex);
+    while (true) {
+        while (num_ready == 0 && !finishing) pthread_cond_wait(&capture_cond, &capture_mutex);
+        if (num_ready == 0) break;
+        CaptureSlot* slot = &slots[first_ready];
+        pthread_mutex_unlock(&capture_mutex);
+        encode_slot(slot);
+        pthread_mutex_lock(&capture_mutex);
+        first_ready = (first_ready + 1) % CAPTURE_SLOTS;
+        num_ready--;
+        num_written++;
+    }
+    pthread_mutex_unlock(&capture_mutex);
+    return NULL;
+}
+
+void capture_toggle() {
+    capturing = !capturing;
+    if (capturing && !make_dir(CAPTURE_DIR)) {
+        fprintf(stderr, "Failed to create " CAPTURE_DIR "/\n");
+        capturing = false;
+    }
+    if (capturing && !encoder_started) encoder_started = pthread_create(&encoder, NULL, capture_encoder, NULL) == 0;
+    printf("Capture %s\n", capturing ? "started" : "stopped");
+}
+
+// copies the frame into the next free slot for the encoder thread, the frame is dropped if none is free
+void capture_frame(Window* window, Buffer* buffer, int width, int height) {
+    if (!capturing || !encoder_started) return;
+    pthread_mutex_lock(&capture_mutex);
+    bool full = num_ready == CAPTURE_SLOTS;
+    CaptureSlot* slot = &slots[(first_ready + num_ready) % CAPTURE_SLOTS];
+    pthread_mutex_unlock(&capture_mutex);
+    int frame = num_frames++;
+    if (full) {
+        num_dropped++;
+        return;
+    }
+    if (slot->width != width || slot->height != height) {
+        free(slot->pixels);
+        slot->pixels = malloc(sizeof(Color) * width * height);
+        slot->width = width;
+        slot->height = height;
+    }
+    if (!graphics_read_buffer(window, buffer, slot->pixels)) {
+        num_dropped++;
+        return;
+    }
+    slot->frame = frame;
+    pthread_mutex_lock(&capture_mutex);
+    num_ready++;
+    pthread_cond_signal(&capture_cond);
+    pthread_mutex_unlock(&capture_mutex);
+}
+
+// waits for the encoder to write every queued frame
+void capture_finish() {
+    if (!encoder_started) return;
+    pthread_mutex_lock(&capture_mutex);
+    finishing = true;
+    pthread_cond_signal(&capture_cond);
+    pthread_mutex_unlock(&capture_mutex);
+    pthread_join(encoder, NULL);
+    encoder_started = false;
+    printf("Captured %d frames to " CAPTURE_DIR "/, dropped %d\n", num_written, num_dropped);
+}
@@ -0,0 +1,10 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "io/graphics.h"
+
+void capture_toggle();
+void capture_frame(Window* window, Buffer* buffer, int width, int height);
+void capture_finish();
+
+#endif
@@ -0,0 +1,223 @@
+#include "engine.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_PLANES 3
+
+struct CollisionMask {
+    unsigned generation;
+    uint8_t* tiles;
+    int start_x, start_y, end_x, end_y;
+    int width, height, pitch;
+    uint64_t* bits;
+};
+
+static int engine_tile_flags(TileInfo* info) {
+    int flags = 0;
+    if (info->collision == Collision_Solid) flags |= CollisionFlag_Solid;
+    if (info->collision == Collision_TopOnly) flags |= CollisionFlag_TopOnly;
+    if (info->has_collision_handler) flags |= CollisionFlag_Event;
+    return flags;
+}
+
+static bool engine_mask_valid(struct CollisionMask* mask, TilemapNode* tilemap) {
+    return
+        mask->tiles == tilemap->tiles &&
+        mask->start_x == tilemap->start_x && mask->start_y == tilemap->start_y &&
+        mask->end_x   == tilemap->end_x   && mask->end_y   == tilemap->end_y;
+}
+
+static bool engine_mask_contains(struct CollisionMask* mask, int x, int y) {
+    return x >= mask->start_x && y >= mask->start_y && x < mask->start_x + mask->width && y < mask->start_y + mask->height;
+}
+
+static uint64_t* engine_mask_row(struct CollisionMask* mask, int plane, int y) {
+    return mask->bits + ((size_t)plane * mask->height + (y - mask->start_y)) * mask->pitch;
+}
+
+static uint64_t engine_mask_word(struct CollisionMask* mask, int y, int word, int flags) {
+    uint64_t bits = 0;
+    for (int plane = 0; plane < NUM_PLANES; plane++) {
+        if (flags & (1 << plane)) bits |= engine_mask_row(mask, plane, y)[word];
+    }
+    return bits;
+}
+
+static void engine_write_mask_bit(struct CollisionMask* mask, int x, int y, int flags) {
+    int col = x - mask->start_x;
+    for (int plane = 0; plane < NUM_PLANES; plane++) {
+        uint64_t* word = &engine_mask_row(mask, plane, y)[col >> 6];
+        if (flags & (1 << plane)) *word |=  (1ull << (col & 63));
+        else                      *word &= ~(1ull << (col & 63));
+    }
+}
+
+static struct CollisionMask* engine_get_collision_mask(TilemapNode* tilemap, TilesetNode* tileset) {
+    struct CollisionMask* mask = tilemap->collision_mask;
+    unsigned generation = tileset ? tileset->cache->generation : 0;
+    if (mask && mask->generation == generation && engine_mask_valid(mask, tilemap)) return mask;
+    if (!mask) mask = tilemap->collision_mask = calloc(sizeof(struct CollisionMask), 1);
+    mask->generation = generation;
+    mask->tiles = tilemap->tiles;
+    mask->start_x = tilemap->start_x;
+    mask->start_y = tilemap->start_y;
+    mask->end_x = tilemap->end_x;
+    mask->end_y = tilemap->end_y;
+    mask->width  = tilemap->tiles ? tilemap->end_x - tilemap->start_x : 0;
+    mask->height = tilemap->tiles ? tilemap->end_y - tilemap->start_y : 0;
+    mask->pitch = (mask->width + 63) / 64;
+    size_t size = sizeof(uint64_t) * NUM_PLANES * mask->pitch * mask->height;
+    mask->bits = realloc(mask->bits, size);
+    memset(mask->bits, 0, size);
+    if (!tileset) return mask;
+    for (int y = 0; y < mask->height; y++) {
+        for (int x = 0; x < mask->width; x++) {
+            int flags = engine_tile_flags(&tileset->cache->tiles[tilemap->tiles[y * mask->width + x]]);
+            if (flags) engine_write_mask_bit(mask, mask->start_x + x, mask->start_y + y, flags);
+        }
+    }
+    return mask;
+}
+
+void engine_free_collision_mask(TilemapNode* tilemap) {
+    if (!tilemap->collision_mask) return;
+    free(tilemap->collision_mask->bits);
+    free(tilemap->collision_mask);
+    tilemap->collision_mask = NULL;
+}
+
+void engine_update_collision_mask(TilemapNode* tilemap, int x, int y, uint8_t tile) {
+    struct CollisionMask* mask = tilemap->collision_mask;
+    TilesetNode* tileset = tilemap->cached_tileset;
+    if (!tileset || !tileset->cache || tileset->cache->dirty || mask->generation != tileset->cache->generation) return;
+    if (!engine_mask_valid(mask, tilemap) || !engine_mask_contains(mask, x, y)) return;
+    engine_write_mask_bit(mask, x, y, engine_tile_flags(&tileset->cache->tiles[tile]));
+}
+
+void engine_update_collision_region(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y) {
+    struct CollisionMask* mask = tilemap->collision_mask;
+    TilesetNode* tileset = tilemap->cached_tileset;
+    if (!tileset || !tileset->cache || tileset->cache->dirty || mask->generation != tileset->cache->generation) return;
+    if (!engine_mask_valid(mask, tilemap)) return;
+    for (int y = min_y; y < max_y; y++) for (int x = min_x; x < max_x; x++) {
+        if (!engine_mask_contains(mask, x, y)) continue;
+        uint8_t tile = tilemap->tiles[(y - mask->start_y) * mask->width + (x - mask->start_x)];
+        engine_write_mask_bit(mask, x, y, engine_tile_flags(&tileset->cache->tiles[tile]));
+    }
+}
+
+static bool engine_check_tile(TilemapNode* tilemap, TilesetNode* tileset, int x, int y, int flags) {
+    if (!tileset) return false;
+    return engine_tile_flags(&tileset->cache->tiles[engine_get_tile(tilemap, x, y)]) & flags;
+}
+
+static bool engine_check_row(struct CollisionMask* mask, int y, int from, int to, int flags) {
+    int first = (from - mask->start_x) >> 6;
+    int last = (to - 1 - mask->start_x) >> 6;
+    for (int word = first; word <= last; word++) {
+        uint64_t bits = engine_mask_word(mask, y, word, flags);
+        if (word == first) bits &= ~0ull << ((from - mask->start_x) & 63);
+        if (word == last)  bits &= ~0ull >> (63 - ((to - 1 - mask->start_x) & 63));
+        if (bits) return true;
+    }
+    return false;
+}
+
+bool engine_check_tiles(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y, int flags) {
+    TilesetNode* tileset = engine_get_tileset(tilemap);
+    struct CollisionMask* mask = engine_get_collision_mask(tilemap, tileset);
+    int mask_end_x = mask->start_x + mask->width;
+    for (int y = min_y; y < max_y; y++) {
+        if (y < mask->start_y || y >= mask->start_y + mask->height) {
+            for (int x = min_x; x < max_x; x++) if (engine_check_tile(tilemap, tileset, x, y, flags)) return true;
+            continue;
+        }
+        int from = min_x < mask->start_x ? mask->start_x : min_x;
+        int to   = max_x > mask_end_x    ? mask_end_x    : max_x;
+        for (int x = min_x; x < from && x < max_x; x++) if (engine_check_tile(tilemap, tileset, x, y, flags)) return true;
+        for (int x = to > min_x ? to : min_x; x < max_x; x++) if (engine_check_tile(tilemap, tileset, x, y, flags)) return true;
+        if (from < to && engine_check_row(mask, y, from, to, flags)) return true;
+    }
+    return false;
+}
+
+bool engine_overlaps_solid(TilemapNode* tilemap, float x1, float y1, float x2, float y2, int flags) {
+    return engine_check_tiles(tilemap, floorf(x1), floorf(y1), ceilf(x2), ceilf(y2), flags);
+}
+
+static bool engine_tile_at(TilemapNode* tilemap, TilesetNode* tileset, struct CollisionMask* mask, int x, int y, int flags) {
+    if (!engine_mask_contains(mask, x, y)) return engine_check_tile(tilemap, tileset, x, y, flags);
+    int col = x - mask->start_x;
+    return engine_mask_word(mask, y, col >> 6, flags) & (1ull << (col & 63));
+}
+
+bool engine_raycast(TilemapNode* tilemap, float x, float y, float dir_x, float dir_y, float max_dist, int flags, int* hit_x, int* hit_y, float* dist) {
+    TilesetNode* tileset = engine_get_tileset(tilemap);
+    struct CollisionMask* mask = engine_get_collision_mask(tilemap, tileset);
+    float length = sqrtf(dir_x * dir_x + dir_y * dir_y);
+    if (length == 0) return false;
+    dir_x /= length;
+    dir_y /= length;
+    int tile_x = floorf(x), tile_y = floorf(y);
+    int step_x = dir_x > 0 ? 1 : -1;
+    int step_y = dir_y > 0 ? 1 : -1;
+    float delta_x = dir_x == 0 ? INFINITY : fabsf(1 / dir_x);
+    float delta_y = dir_y == 0 ? INFINITY : fabsf(1 / dir_y);
+    float next_x = dir_x == 0 ? INFINITY : (dir_x > 0 ? tile_x + 1 - x : x - tile_x) * delta_x;
+    float next_y = dir_y == 0 ? INFINITY : (dir_y > 0 ? tile_y + 1 - y : y - tile_y) * delta_y;
+    float traveled = 0;
+    while (traveled <= max_dist) {
+        // horizontal rays inside the mask skip over empty words at once
+        if (dir_y == 0 && engine_mask_contains(mask, tile_x, tile_y)) {
+            int col = tile_x - mask->start_x;
+            uint64_t bits = engine_mask_word(mask, tile_y, col >> 6, flags);
+            if (step_x > 0) bits &= ~0ull << (col & 63);
+            else bits &= ~0ull >> (63 - (col & 63));
+            if (bits) {
+                tile_x = mask->start_x + (col & ~63) + (step_x > 0 ? __builtin_ctzll(bits) : 63 - __builtin_clzll(bits));
+                traveled = step_x > 0 ? tile_x - x : x - (tile_x + 1);
+                if (traveled < 0) traveled = 0;
+                if (traveled > max_dist) return false;
+                if (hit_x) *hit_x = tile_x;
+                if (hit_y) *hit_y = tile_y;
+                if (dist) *dist = traveled;
+                return true;
+            }
+            int next_col = step_x > 0 ? (col | 63) + 1 : (col & ~63) - 1;
+            if (next_col > mask->width) next_col = mask->width;
+            tile_x = mask->start_x + next_col;
+            traveled = step_x > 0 ? tile_x - x : x - (tile_x + 1);
+            if (traveled < 0) traveled = 0;
+            next_x = traveled + delta_x;
+            continue;
+        }
+        if (engine_tile_at(tilemap, tileset, mask, tile_x, tile_y, flags)) {
+            if (hit_x) *hit_x = tile_x;
+            if (hit_y) *hit_y = tile_y;
+            if (dist) *dist = traveled;
+            return true;
+        }
+        if (next_x < next_y) {
+            traveled = next_x;
+            next_x += delta_x;
+            tile_x += step_x;
+        }
+        else {
+            traveled = next_y;
+            next_y += delta_y;
+            tile_y += step_y;
+        }
+    }
+    return false;
+}
+
+float engine_ground_probe(TilemapNode* tilemap, float x, float y, float max_depth) {
+    TilesetNode* tileset = engine_get_tileset(tilemap);
+    struct CollisionMask* mask = engine_get_collision_mask(tilemap, tileset);
+    int tile_x = floorf(x);
+    for (int tile_y = ceilf(y); tile_y - y <= max_depth; tile_y++) {
+        if (engine_tile_at(tilemap, tileset, mask, tile_x, tile_y, CollisionFlag_Solid | CollisionFlag_TopOnly)) return tile_y - y;
+    }
+    return -1;
+}
@@ -27,6 +27,12 @@ typedef enum {
     Collision_Solid,
 } Collision;
 
+typedef enum {
+    CollisionFlag_Solid   = 1 << 0,
+    CollisionFlag_TopOnly = 1 << 1,
+    CollisionFlag_Event   = 1 << 2,
+} CollisionFlag;
+
 typedef struct Node Node;
 struct Node {
     NodeType type;
@@ -42,6 +48,23 @@ struct Node {
 #undef NODE
 #undef _
 
+typedef struct {
+    TileNode* tile;
+    Collision collision;
+    bool has_collision_handler;
+    bool has_multiple_textures;
+    int(*texture)(TilemapNode* tilemap, TileNode* tile, int x, int y);
+} TileInfo;
+
+typedef struct LevelAsset LevelAsset;
+
+struct TilesetCache {
+    bool dirty;
+    unsigned generation;
+    TileInfo tiles[256];
+    struct { int x, y; } src[256];
+};
+
 #define engine_new_node(t) ({ \
     t##Node* node = calloc(sizeof(t##Node), 1); \
     node->node.type = NodeType_##t; \
@@ -49,6 +72,11 @@ struct Node {
     node; \
 })
 
+// counts calls into script callbacks while profiling, for finding the hot ones
+#define engine_count_call(func) (engine_profiling ? engine_record_call((void*)(func)) : (void)0)
+
+extern bool engine_profiling;
+
 void engine_cleanup();
 
 void engine_attach_node(Node* parent, Node* child);
@@ -56,13 +84,65 @@ void engine_detach_node(Node* child);
 void engine_delete_node(Node* node);
 Node* engine_deep_copy(Node* node);
 
+TilesetNode* engine_get_tileset(TilemapNode* tilemap);
+void engine_build_tileset_cache(TilesetNode* tileset);
+void engine_invalidate_tileset_cache(TilesetNode* tileset);
+
+void engine_free_collision_mask(TilemapNode* tilemap);
+void engine_update_collision_mask(TilemapNode* tilemap, int x, int y, uint8_t tile);
+void engine_update_collision_region(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y);
+bool engine_check_tiles(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y, int flags);
+bool engine_overlaps_solid(TilemapNode* tilemap, float x1, float y1, float x2, float y2, int flags);
+bool engine_raycast(TilemapNode* tilemap, float x, float y, float dir_x, float dir_y, float max_dist, int flags, int* hit_x, int* hit_y, float* dist);
+float engine_ground_probe(TilemapNode* tilemap, float x, float y, float max_depth);
+
+void engine_spatial_insert(TilemapNode* tilemap, int slot, EntityNode* entity);
+void engine_spatial_remove(TilemapNode* tilemap, int slot);
+void engine_spatial_move(TilemapNode* tilemap, int slot, EntityNode* entity);
+void engine_free_spatial_index(TilemapNode* tilemap);
+int engine_query_radius(TilemapNode* tilemap, float x, float y, float r, void(*callback)(EntityNode* entity, void* data), void* data);
+int engine_query_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, void(*callback)(EntityNode* entity, void* data), void* data);
+int engine_find_radius(TilemapNode* tilemap, float x, float y, float r, EntityNode** out, int capacity);
+int engine_find_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, EntityNode** out, int capacity);
+
 void engine_set_tile(TilemapNode* node, int x, int y, uint8_t tile);
+void engine_fill_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t tile);
+void engine_map_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t(*func)(TilemapNode* tilemap, int x, int y, void* data), void* data);
+void engine_copy_tiles(TilemapNode* dst, int dst_x, int dst_y, TilemapNode* src, int min_x, int min_y, int max_x, int max_y);
+int engine_flood_fill(TilemapNode* node, int x, int y, uint8_t tile);
 uint8_t engine_get_tile(TilemapNode* node, int x, int y);
+void engine_get_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t* out);
 void* engine_property(EntityNode* node, const char* name);
 EntityNode* engine_find_entity(LevelRootNode* level, const char* name);
 EntityNode* engine_find_entity_on_tilemap(TilemapNode* tilemap, const char* name);
 
+LevelAsset* engine_parse_level_asset(const uint8_t* data, size_t length);
+void engine_load_level_tilemap(TilemapNode* tilemap, LevelAsset* asset);
+void engine_level_bounds(LevelAsset* asset, int* start_x, int* start_y, int* end_x, int* end_y);
+void engine_level_decode(LevelAsset* asset, int min_x, int min_y, int max_x, int max_y, uint8_t* out, int pitch);
+int engine_level_num_spawns(LevelAsset* asset);
+const char* engine_level_oob_provider(LevelAsset* asset);
+const char* engine_level_spawn(LevelAsset* asset, int index, float* x, float* y);
+bool engine_save_level_asset(TilemapNode* tilemap, const char* oob_tile_provider, const char* filename);
+
+void engine_stream_tilemap(TilemapNode* tilemap, LevelAsset* asset, int budget, int fallback_tile, Node*(*spawn)(const char* func, float x, float y), float focus_x, float focus_y);
+void engine_stream_view(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y);
+void engine_stream_update(TilemapNode* tilemap);
+uint8_t engine_stream_get_tile(TilemapNode* tilemap, int x, int y);
+void engine_stream_set_tile(TilemapNode* tilemap, int x, int y, uint8_t tile);
+void engine_stream_decorate(TilemapNode* tilemap, uint8_t(*func)(TilemapNode* tilemap, int x, int y, void* data), void* data);
+uint8_t* engine_stream_snapshot(TilemapNode* tilemap);
+void engine_stream_spawns(TilemapNode* tilemap, void(*callback)(float x, float y, const char* func, void* data), void* data);
+void engine_copy_stream(TilemapNode* copy, TilemapNode* orig);
+void engine_free_stream(TilemapNode* tilemap);
+
 void engine_update(LevelRootNode* node, float delta_time);
 void engine_render(LevelRootNode* node, float width, float height);
+void engine_entity_screen_pos(EntityNode* entity, float* x, float* y);
+
+void engine_set_profiling(bool enabled);
+void engine_record_call(void* func);
+void engine_record_frame();
+uint64_t engine_profile_results(void** funcs, uint64_t* calls, int* count);
 
 #endif
@@ -0,0 +1,230 @@
+#include "engine.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// .lvl layout, little endian:
+//   "LVL1"
+//   i32 width, height, start_x, start_y
+//   u16 length, char oob_tile_provider[length]         (null terminated)
+//   u32 size, u8 tiles[size]                             (runs of u8 count, u8 tile)
+//   u32 count, { f32 x, y; u16 length; char func[length] } spawns[count]
+
+#define LEVEL_MAGIC "LVL1"
+
+struct LevelAsset {
+    int width, height, start_x, start_y;
+    const char* oob_tile_provider;
+    const uint8_t* tiles;
+    uint32_t tiles_size;
+    int num_spawns;
+    const uint8_t** spawns;
+    struct { uint32_t run, offset; }* rows; // where each row starts in the runs, for decoding parts of the map
+};
+
+typedef struct {
+    const uint8_t* data;
+    size_t length, offset;
+} Reader;
+
+static const uint8_t* engine_read(Reader* reader, size_t size) {
+    if (reader->length - reader->offset < size) return NULL;
+    const uint8_t* ptr = reader->data + reader->offset;
+    reader->offset += size;
+    return ptr;
+}
+
+static bool engine_read_value(Reader* reader, void* value, size_t size) {
+    const uint8_t* ptr = engine_read(reader, size);
+    if (ptr) memcpy(value, ptr, size);
+    return ptr;
+}
+
+static const char* engine_read_string(Reader* reader) {
+    uint16_t length;
+    if (!engine_read_value(reader, &length, sizeof(length)) || length == 0) return NULL;
+    const char* str = (const char*)engine_read(reader, length);
+    if (!str || str[length - 1] != 0) return NULL;
+    return str;
+}
+
+LevelAsset* engine_parse_level_asset(const uint8_t* data, size_t length) {
+    Reader reader = { .data = data, .length = length };
+    const uint8_t* magic = engine_read(&reader, 4);
+    if (!magic || memcmp(magic, LEVEL_MAGIC, 4) != 0) return NULL;
+    LevelAsset asset = {};
+    uint32_t num_spawns;
+    if (
+        !engine_read_value(&reader, &asset.width, sizeof(int32_t)) ||
+        !engine_read_value(&reader, &asset.height, sizeof(int32_t)) ||
+        !engine_read_value(&reader, &asset.start_x, sizeof(int32_t)) ||
+        !engine_read_value(&reader, &asset.start_y, sizeof(int32_t)) ||
+        !(asset.oob_tile_provider = engine_read_string(&reader)) ||
+        !engine_read_value(&reader, &asset.tiles_size, sizeof(uint32_t)) ||
+        !(asset.tiles = engine_read(&reader, asset.tiles_size)) ||
+        !engine_read_value(&reader, &num_spawns, sizeof(uint32_t))
+    ) return NULL;
+    if (asset.width < 0 || asset.height < 0 || asset.tiles_size % 2 != 0) return NULL;
+    size_t total = 0;
+    for (uint32_t i = 0; i < asset.tiles_size; i += 2) total += asset.tiles[i];
+    if (total != (size_t)asset.width * asset.height) return NULL;
+    asset.rows = malloc(sizeof(*asset.rows) * (asset.height + 1));
+    total = 0;
+    for (uint32_t i = 0, row = 0; i < asset.tiles_size && row < asset.height; i += 2) {
+        for (; row < asset.height && (size_t)row * asset.width < total + asset.tiles[i]; row++) {
+            asset.rows[row].run = i;
+            asset.rows[row].offset = (size_t)row * asset.width - total;
+        }
+        total += asset.tiles[i];
+    }
+    if (num_spawns > (length - reader.offset) / (sizeof(float) * 2 + sizeof(uint16_t))) {
+        free(asset.rows);
+        return NULL;
+    }
+    asset.num_spawns = num_spawns;
+    asset.spawns = malloc(sizeof(*asset.spawns) * (num_spawns + 1));
+    for (uint32_t i = 0; i < num_spawns; i++) {
+        asset.spawns[i] = reader.data + reader.offset;
+        if (!engine_read(&reader, sizeof(float) * 2) || !engine_read_string(&reader)) {
+            free(asset.rows);
+            free(asset.spawns);
+            return NULL;
+        }
+    }
+    LevelAsset* out = malloc(sizeof(LevelAsset));
+    *out = asset;
+    return out;
+}
+
+void engine_load_level_tilemap(TilemapNode* tilemap, LevelAsset* asset) {
+    uint8_t* tiles = asset->width && asset->height ? malloc(asset->width * asset->height) : NULL;
+    size_t offset = 0;
+    for (uint32_t i = 0; i < asset->tiles_size; i += 2) {
+        memset(tiles + offset, asset->tiles[i + 1], asset->tiles[i]);
+        offset += asset->tiles[i];
+    }
+    free(tilemap->tiles);
+    tilemap->tiles = tiles;
+    tilemap->start_x = asset->start_x;
+    tilemap->start_y = asset->start_y;
+    tilemap->end_x = asset->start_x + asset->width;
+    tilemap->end_y = asset->start_y + asset->height;
+}
+
+void engine_level_bounds(LevelAsset* asset, int* start_x, int* start_y, int* end_x, int* end_y) {
+    *start_x = asset->start_x;
+    *start_y = asset->start_y;
+    *end_x = asset->start_x + asset->width;
+    *end_y = asset->start_y + asset->height;
+}
+
+// decodes a rect in level coordinates into out, tiles outside of the level are left untouched
+void engine_level_decode(LevelAsset* asset, int min_x, int min_y, int max_x, int max_y, uint8_t* out, int pitch) {
+    int from_x = min_x > asset->start_x ? min_x : asset->start_x;
+    int to_x   = max_x < asset->start_x + asset->width ? max_x : asset->start_x + asset->width;
+    int from_y = min_y > asset->start_y ? min_y : asset->start_y;
+    int to_y   = max_y < asset->start_y + asset->height ? max_y : asset->start_y + asset->height;
+    if (from_x >= to_x) return;
+    for (int y = from_y; y < to_y; y++) {
+        uint32_t run = asset->rows[y - asset->start_y].run;
+        int left = asset->tiles[run] - asset->rows[y - asset->start_y].offset;
+        int x = asset->start_x;
+        // skip to the first requested column
+        while (x + left <= from_x) {
+            x += left;
+            run += 2;
+            left = asset->tiles[run];
+        }
+        uint8_t* row = out + (y - min_y) * pitch;
+        for (int tx = from_x; tx < to_x;) {
+            int count = x + left - tx;
+            if (count > to_x - tx) count = to_x - tx;
+            memset(row + (tx - min_x), asset->tiles[run + 1], count);
+            tx += count;
+            x += left;
+            run += 2;
+            if (run < asset->tiles_size) left = asset->tiles[run];
+        }
+    }
+}
+
+int engine_level_num_spawns(LevelAsset* asset) {
+    return asset->num_spawns;
+}
+
+const char* engine_level_oob_provider(LevelAsset* asset) {
+    return asset->oob_tile_provider;
+}
+
+const char* engine_level_spawn(LevelAsset* asset, int index, float* x, float* y) {
+    if (index < 0 || index >= asset->num_spawns) return NULL;
+    const uint8_t* spawn = asset->spawns[index];
+    memcpy(x, spawn, sizeof(float));
+    memcpy(y, spawn + sizeof(float), sizeof(float));
+    return (const char*)spawn + sizeof(float) * 2 + sizeof(uint16_t);
+}
+
+static void engine_write_string(FILE* f, const char* str) {
+    uint16_t length = strlen(str) + 1;
+    fwrite(&length, sizeof(length), 1, f);
+    fwrite(str, length, 1, f);
+}
+
+typedef struct {
+    FILE* file;
+    uint32_t count;
+} SpawnWriter;
+
+static void engine_write_spawn(float x, float y, const char* func, void* data) {
+    SpawnWriter* writer = data;
+    float pos[] = { x, y };
+    writer->count++;
+    if (!writer->file) return;
+    fwrite(pos, sizeof(pos), 1, writer->file);
+    engine_write_string(writer->file, func);
+}
+
+// a first pass without a file counts the spawns
+static void engine_write_spawns(TilemapNode* tilemap, SpawnWriter* writer) {
+    for (int i = 0; i < tilemap->node.children_size; i++) {
+        Node* child = tilemap->node.children[i];
+        if (!child || child->type != NodeType_Entity || !((EntityNode*)child)->func) continue;
+        EntityNode* entity = (EntityNode*)child;
+        engine_write_spawn(entity->pos_x, entity->pos_y, entity->func, writer);
+    }
+    if (tilemap->stream) engine_stream_spawns(tilemap, engine_write_spawn, writer);
+}
+
+bool engine_save_level_asset(TilemapNode* tilemap, const char* oob_tile_provider, const char* filename) {
+    FILE* f = fopen(filename, "wb");
+    if (!f) return false;
+    uint8_t* tiles = tilemap->stream ? engine_stream_snapshot(tilemap) : tilemap->tiles;
+    int32_t header[] = {
+        tiles ? tilemap->end_x - tilemap->start_x : 0,
+        tiles ? tilemap->end_y - tilemap->start_y : 0,
+        tilemap->start_x, tilemap->start_y,
+    };
+    fwrite(LEVEL_MAGIC, 4, 1, f);
+    fwrite(header, sizeof(header), 1, f);
+    engine_write_string(f, oob_tile_provider);
+    size_t num_tiles = (size_t)header[0] * header[1];
+    uint8_t* runs = malloc(num_tiles * 2);
+    uint32_t size = 0;
+    for (size_t i = 0; i < num_tiles;) {
+        uint8_t tile = tiles[i];
+        int count = 0;
+        while (i < num_tiles && tiles[i] == tile && count < 255) i++, count++;
+        runs[size++] = count;
+        runs[size++] = tile;
+    }
+    fwrite(&size, sizeof(size), 1, f);
+    fwrite(runs, size, 1, f);
+    free(runs);
+    if (tiles != tilemap->tiles) free(tiles);
+    SpawnWriter writer = { NULL, 0 };
+    engine_write_spawns(tilemap, &writer);
+    fwrite(&writer.count, sizeof(writer.count), 1, f);
+    writer.file = f;
+    engine_write_spawns(tilemap, &writer);
+    return fclose(f) == 0;
+}
@@ -0,0 +1,59 @@
+#include "engine.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_ENTRIES 1024
+
+typedef struct {
+    void* func;
+    uint64_t calls;
+} ProfileEntry;
+
+bool engine_profiling;
+
+static ProfileEntry entries[NUM_ENTRIES];
+static uint64_t num_frames;
+
+static int compare_calls(const void* a, const void* b) {
+    uint64_t x = ((ProfileEntry*)a)->calls, y = ((ProfileEntry*)b)->calls;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+void engine_set_profiling(bool enabled) {
+    engine_profiling = enabled;
+}
+
+void engine_record_call(void* func) {
+    unsigned slot = ((uintptr_t)func >> 4) * 2654435761u & (NUM_ENTRIES - 1);
+    for (int i = 0; i < NUM_ENTRIES; i++, slot = (slot + 1) & (NUM_ENTRIES - 1)) {
+        if (entries[slot].func == func) {
+            entries[slot].calls++;
+            return;
+        }
+        if (entries[slot].func) continue;
+        entries[slot].func = func;
+        entries[slot].calls = 1;
+        return;
+    }
+}
+
+void engine_record_frame() {
+    if (engine_profiling) num_frames++;
+}
+
+// fills funcs and calls with the most called script callbacks, returns the number of frames profiled
+uint64_t engine_profile_results(void** funcs, uint64_t* calls, int* count) {
+    ProfileEntry sorted[NUM_ENTRIES];
+    int num_sorted = 0;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        if (entries[i].func) sorted[num_sorted++] = entries[i];
+    }
+    qsort(sorted, num_sorted, sizeof(ProfileEntry), compare_calls);
+    if (*count > num_sorted) *count = num_sorted;
+    for (int i = 0; i < *count; i++) {
+        funcs[i] = sorted[i].func;
+        calls[i] = sorted[i].calls;
+    }
+    return num_frames;
+}
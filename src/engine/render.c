@@ -4,8 +4,6 @@
 
 #include <stdlib.h>
 
-extern TilesetNode* engine_get_tileset(TilemapNode* tilemap);
-
 static void engine_get_tilemap_offsets(TilemapNode* tilemap, TilesetNode* tileset, float cam_x, float cam_y, float* offset_x, float* offset_y) {
     if (!tileset) return;
     *offset_x = cam_x * tilemap->scroll_speed_x / tilemap->scale_x / tileset->tile_width  - tilemap->scroll_offset_x;
@@ -19,6 +17,7 @@ static void engine_render_entity(EntityNode* entity, TilesetNode* tileset, float
     for (int i = 0; i < entity->node.children_size && !tex; i++) {
         if (!entity->node.children[i]) continue;
         if (entity->node.children[i]->type != NodeType_EntityTexture) continue;
+        engine_count_call(((EntityTextureNode*)entity->node.children[i])->func);
         tex = ((EntityTextureNode*)entity->node.children[i])->func(entity, tilemap, &sx, &sy, &sw, &sh, &w, &h, &off_x, &off_y);
     }
     if (!tex) return;
@@ -35,21 +34,37 @@ static void engine_render_entity(EntityNode* entity, TilesetNode* tileset, float
 
 static void engine_render_tile(TilemapNode* tilemap, TilesetNode* tileset, float x, float y, float offset_x, float offset_y) {
     if (!tileset) return;
-    TileNode* tile = (TileNode*)tileset->node.children[engine_get_tile(tilemap, x, y)];
-    if (tile == NULL || tile->node.type != NodeType_Tile) return;
-    int index = -1;
-    for (int i = 0; i < tile->node.children_size && index == -1; i++) {
-        if (!tile->node.children[i]) continue;
-        if (tile->node.children[i]->type == NodeType_TileTexture)
-            index = ((TileTextureNode*)tile->node.children[i])->func(tilemap, tile, x, y);
+    TileInfo* info = &tileset->cache->tiles[engine_get_tile(tilemap, x, y)];
+    if (!info->texture) return;
+    engine_count_call(info->texture);
+    int index = info->texture(tilemap, info->tile, x, y);
+    if (index == -1 && info->has_multiple_textures) {
+        bool skipped = false;
+        for (int i = 0; i < info->tile->node.children_size && index == -1; i++) {
+            if (!info->tile->node.children[i]) continue;
+            if (info->tile->node.children[i]->type != NodeType_TileTexture) continue;
+            if (!skipped) skipped = true;
+            else {
+                engine_count_call(((TileTextureNode*)info->tile->node.children[i])->func);
+                index = ((TileTextureNode*)info->tile->node.children[i])->func(tilemap, info->tile, x, y);
+            }
+        }
     }
     if (index == -1) return;
+    int src_x, src_y;
+    if (index >= 0 && index < 256) {
+        src_x = tileset->cache->src[index].x;
+        src_y = tileset->cache->src[index].y;
+    }
+    else {
+        src_x = (int)(index % tileset->tiles_per_row) * tileset->tile_width;
+        src_y = (int)(index / tileset->tiles_per_row) * tileset->tile_height;
+    }
     graphics_draw(NULL, tileset->tileset,
         (x - offset_x) * tilemap->scale_x * tileset->tile_width,
         (y - offset_y) * tilemap->scale_y * tileset->tile_height,
         tileset->tile_width * tilemap->scale_x, tileset->tile_height * tilemap->scale_y,
-        (int)(index % tileset->tiles_per_row) * tileset->tile_width,
-        (int)(index / tileset->tiles_per_row) * tileset->tile_height,
+        src_x, src_y,
         tileset->tile_width, tileset->tile_height,
         GRAY(255)
     );
@@ -64,6 +79,7 @@ static void engine_render_tilemap(TilemapNode* tilemap, float width, float heigh
         int min_y = floorf(offset_y);
         int max_x = ceilf((offset_x + width  / tilemap->scale_x / tileset->tile_width));
         int max_y = ceilf((offset_y + height / tilemap->scale_y / tileset->tile_height));
+        if (tilemap->stream) engine_stream_view(tilemap, min_x, min_y, max_x + 1, max_y + 1);
         for (int x = min_x; x <= max_x; x++) {
             for (int y = min_y; y <= max_y; y++) {
                 engine_render_tile(tilemap, tileset, x, y, offset_x, offset_y);
@@ -77,6 +93,17 @@ static void engine_render_tilemap(TilemapNode* tilemap, float width, float heigh
     }
 }
 
+// where the entity's position ends up in the target the level is rendered to
+void engine_entity_screen_pos(EntityNode* entity, float* x, float* y) {
+    TilemapNode* tilemap = (TilemapNode*)entity->node.parent;
+    LevelRootNode* level = (LevelRootNode*)tilemap->node.parent;
+    TilesetNode* tileset = engine_get_tileset(tilemap);
+    float offset_x = 0, offset_y = 0;
+    if (level && level->node.type == NodeType_LevelRoot) engine_get_tilemap_offsets(tilemap, tileset, level->cam_x, level->cam_y, &offset_x, &offset_y);
+    *x = (entity->pos_x - offset_x) * (tileset ? tileset->tile_width  : 1) * tilemap->scale_x;
+    *y = (entity->pos_y - offset_y) * (tileset ? tileset->tile_height : 1) * tilemap->scale_y;
+}
+
 void engine_render(LevelRootNode* level, float width, float height) {
     for (int i = 0; i < level->node.children_size; i++) {
         if (!level->node.children[i]) continue;
@@ -0,0 +1,205 @@
+#include "engine.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CELL_SIZE 4
+#define NUM_BUCKETS 256
+
+typedef struct {
+    EntityNode* entity;
+    int cell_x, cell_y;
+    int prev, next;
+} SpatialEntry;
+
+struct SpatialIndex {
+    int buckets[NUM_BUCKETS];
+    int capacity;
+    SpatialEntry* entries;
+};
+
+typedef struct {
+    bool radius;
+    float x1, y1, x2, y2;
+    float x, y, r;
+} SpatialRegion;
+
+static int compare_int(const void* a, const void* b) {
+    return *(int*)a - *(int*)b;
+}
+
+static int engine_cell(float pos) {
+    return floorf(pos / CELL_SIZE);
+}
+
+static int engine_cell_bucket(int x, int y) {
+    return ((unsigned)x * 73856093u ^ (unsigned)y * 19349663u) & (NUM_BUCKETS - 1);
+}
+
+static void engine_spatial_unlink(struct SpatialIndex* index, int slot) {
+    if (slot >= index->capacity) return;
+    SpatialEntry* entry = &index->entries[slot];
+    if (!entry->entity) return;
+    if (entry->prev >= 0) index->entries[entry->prev].next = entry->next;
+    else index->buckets[engine_cell_bucket(entry->cell_x, entry->cell_y)] = entry->next;
+    if (entry->next >= 0) index->entries[entry->next].prev = entry->prev;
+    entry->entity = NULL;
+}
+
+static void engine_spatial_link(struct SpatialIndex* index, int slot, EntityNode* entity) {
+    if (slot >= index->capacity) {
+        int old_capacity = index->capacity;
+        while (slot >= index->capacity) index->capacity = index->capacity == 0 ? 16 : index->capacity * 2;
+        index->entries = realloc(index->entries, sizeof(SpatialEntry) * index->capacity);
+        memset(index->entries + old_capacity, 0, sizeof(SpatialEntry) * (index->capacity - old_capacity));
+    }
+    SpatialEntry* entry = &index->entries[slot];
+    entry->entity = entity;
+    entry->cell_x = engine_cell(entity->pos_x);
+    entry->cell_y = engine_cell(entity->pos_y);
+    int bucket = engine_cell_bucket(entry->cell_x, entry->cell_y);
+    entry->prev = -1;
+    entry->next = index->buckets[bucket];
+    if (entry->next >= 0) index->entries[entry->next].prev = slot;
+    index->buckets[bucket] = slot;
+}
+
+static struct SpatialIndex* engine_get_spatial_index(TilemapNode* tilemap) {
+    if (tilemap->spatial_index) return tilemap->spatial_index;
+    struct SpatialIndex* index = tilemap->spatial_index = calloc(sizeof(struct SpatialIndex), 1);
+    for (int i = 0; i < NUM_BUCKETS; i++) index->buckets[i] = -1;
+    for (int i = 0; i < tilemap->node.children_size; i++) {
+        if (!tilemap->node.children[i]) continue;
+        if (tilemap->node.children[i]->type != NodeType_Entity) continue;
+        engine_spatial_link(index, i, (EntityNode*)tilemap->node.children[i]);
+    }
+    return index;
+}
+
+void engine_spatial_insert(TilemapNode* tilemap, int slot, EntityNode* entity) {
+    if (!tilemap->spatial_index) return;
+    engine_spatial_unlink(tilemap->spatial_index, slot);
+    engine_spatial_link(tilemap->spatial_index, slot, entity);
+}
+
+void engine_spatial_remove(TilemapNode* tilemap, int slot) {
+    if (!tilemap->spatial_index) return;
+    engine_spatial_unlink(tilemap->spatial_index, slot);
+}
+
+void engine_spatial_move(TilemapNode* tilemap, int slot, EntityNode* entity) {
+    struct SpatialIndex* index = tilemap->spatial_index;
+    if (!index || slot >= index->capacity) return;
+    SpatialEntry* entry = &index->entries[slot];
+    if (entry->entity == entity && entry->cell_x == engine_cell(entity->pos_x) && entry->cell_y == engine_cell(entity->pos_y)) return;
+    engine_spatial_unlink(index, slot);
+    engine_spatial_link(index, slot, entity);
+}
+
+void engine_free_spatial_index(TilemapNode* tilemap) {
+    if (!tilemap->spatial_index) return;
+    free(tilemap->spatial_index->entries);
+    free(tilemap->spatial_index);
+    tilemap->spatial_index = NULL;
+}
+
+// entities can be moved by anything that writes their position, other entities' scripts or the editor,
+// so before a query every entry whose entity left its cell is linked into the new one
+static void engine_spatial_sync(struct SpatialIndex* index) {
+    for (int slot = 0; slot < index->capacity; slot++) {
+        SpatialEntry* entry = &index->entries[slot];
+        if (!entry->entity) continue;
+        if (entry->cell_x == engine_cell(entry->entity->pos_x) && entry->cell_y == engine_cell(entry->entity->pos_y)) continue;
+        EntityNode* entity = entry->entity;
+        engine_spatial_unlink(index, slot);
+        engine_spatial_link(index, slot, entity);
+    }
+}
+
+static bool engine_region_contains(SpatialRegion* region, EntityNode* entity) {
+    if (region->radius) {
+        float dx = entity->pos_x - region->x;
+        float dy = entity->pos_y - region->y;
+        return dx * dx + dy * dy < region->r * region->r;
+    }
+    return
+        entity->pos_x >= region->x1 && entity->pos_x < region->x2 &&
+        entity->pos_y >= region->y1 && entity->pos_y < region->y2;
+}
+
+// fills slots with the children indices of matching entities, in the same order as a scan over tilemap->node.children
+static int engine_spatial_collect(TilemapNode* tilemap, SpatialRegion* region, int* slots) {
+    struct SpatialIndex* index = engine_get_spatial_index(tilemap);
+    int count = 0;
+    int min_x = engine_cell(region->x1), max_x = engine_cell(region->x2);
+    int min_y = engine_cell(region->y1), max_y = engine_cell(region->y2);
+    if ((long)(max_x - min_x + 1) * (max_y - min_y + 1) > NUM_BUCKETS) {
+        for (int i = 0; i < tilemap->node.children_size; i++) {
+            if (!tilemap->node.children[i]) continue;
+            if (tilemap->node.children[i]->type != NodeType_Entity) continue;
+            if (engine_region_contains(region, (EntityNode*)tilemap->node.children[i])) slots[count++] = i;
+        }
+        return count;
+    }
+    engine_spatial_sync(index);
+    for (int y = min_y; y <= max_y; y++) {
+        for (int x = min_x; x <= max_x; x++) {
+            for (int slot = index->buckets[engine_cell_bucket(x, y)]; slot >= 0; slot = index->entries[slot].next) {
+                SpatialEntry* entry = &index->entries[slot];
+                if (entry->cell_x != x || entry->cell_y != y) continue;
+                if (engine_region_contains(region, entry->entity)) slots[count++] = slot;
+            }
+        }
+    }
+    qsort(slots, count, sizeof(int), compare_int);
+    return count;
+}
+
+static int engine_spatial_invoke(TilemapNode* tilemap, SpatialRegion* region, void(*callback)(EntityNode* entity, void* data), void* data) {
+    int slots[tilemap->node.children_size + 1];
+    int count = engine_spatial_collect(tilemap, region, slots);
+    EntityNode* entities[count + 1];
+    for (int i = 0; i < count; i++) entities[i] = (EntityNode*)tilemap->node.children[slots[i]];
+    int invoked = 0;
+    for (int i = 0; i < count; i++) {
+        if (slots[i] >= tilemap->node.children_size || tilemap->node.children[slots[i]] != (Node*)entities[i]) continue; // removed by an earlier callback
+        callback(entities[i], data);
+        invoked++;
+    }
+    return invoked;
+}
+
+static int engine_spatial_fill(TilemapNode* tilemap, SpatialRegion* region, EntityNode** out, int capacity) {
+    int slots[tilemap->node.children_size + 1];
+    int count = engine_spatial_collect(tilemap, region, slots);
+    for (int i = 0; i < count && i < capacity; i++) out[i] = (EntityNode*)tilemap->node.children[slots[i]];
+    return count;
+}
+
+static SpatialRegion engine_radius_region(float x, float y, float r) {
+    return (SpatialRegion){ .radius = true, .x1 = x - r, .y1 = y - r, .x2 = x + r, .y2 = y + r, .x = x, .y = y, .r = r };
+}
+
+static SpatialRegion engine_box_region(float x1, float y1, float x2, float y2) {
+    return (SpatialRegion){ .radius = false, .x1 = x1, .y1 = y1, .x2 = x2, .y2 = y2 };
+}
+
+int engine_query_radius(TilemapNode* tilemap, float x, float y, float r, void(*callback)(EntityNode* entity, void* data), void* data) {
+    SpatialRegion region = engine_radius_region(x, y, r);
+    return engine_spatial_invoke(tilemap, &region, callback, data);
+}
+
+int engine_query_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, void(*callback)(EntityNode* entity, void* data), void* data) {
+    SpatialRegion region = engine_box_region(x1, y1, x2, y2);
+    return engine_spatial_invoke(tilemap, &region, callback, data);
+}
+
+int engine_find_radius(TilemapNode* tilemap, float x, float y, float r, EntityNode** out, int capacity) {
+    SpatialRegion region = engine_radius_region(x, y, r);
+    return engine_spatial_fill(tilemap, &region, out, capacity);
+}
+
+int engine_find_box(TilemapNode* tilemap, float x1, float y1, float x2, float y2, EntityNode** out, int capacity) {
+    SpatialRegion region = engine_box_region(x1, y1, x2, y2);
+    return engine_spatial_fill(tilemap, &region, out, capacity);
+}
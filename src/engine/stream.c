@@ -0,0 +1,462 @@
+#include "engine.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK_SIZE 16
+#define PREFETCH_MARGIN 1 // chunks around the view that are loaded in the background
+
+typedef enum {
+    ChunkState_Paged,
+    ChunkState_Pending,
+    ChunkState_Resident,
+} ChunkState;
+
+typedef struct {
+    ChunkState state;
+    bool spawned, dirty;
+    int decorated; // how many of the stream's decorators ran over the chunk
+    unsigned last_used;
+    uint8_t* tiles;
+    uint8_t* saved; // run length encoded tiles of a modified chunk that got paged out
+    int saved_size;
+    int num_spawns;
+    int* spawns;
+    int num_parked, parked_capacity;
+    Node** parked; // entities that were on the chunk when it got paged out
+} Chunk;
+
+typedef struct {
+    int chunk;
+    uint8_t* tiles;
+} ChunkJob;
+
+typedef struct {
+    uint8_t(*func)(TilemapNode* tilemap, int x, int y, void* data);
+    void* data;
+} Decorator;
+
+struct TileStream {
+    LevelAsset* asset;
+    int start_x, start_y, end_x, end_y;
+    Node*(*spawn)(const char* func, float x, float y);
+    int fallback_tile;
+    int budget, resident, pending;
+    unsigned frame;
+    int chunks_x, chunks_y;
+    Chunk* chunks;
+    int view_min_x, view_min_y, view_max_x, view_max_y; // in chunks, inclusive
+    int num_decorators;
+    Decorator* decorators;
+    bool decorating;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool quit;
+    int num_requests, requests_capacity;
+    int* requests;
+    int num_done, done_capacity;
+    ChunkJob* done;
+};
+
+static int engine_chunk_coord(int pos, int start) {
+    return (pos - start) / CHUNK_SIZE;
+}
+
+static Chunk* engine_get_chunk(struct TileStream* stream, int x, int y) {
+    if (x < stream->start_x || y < stream->start_y || x >= stream->end_x || y >= stream->end_y) return NULL;
+    return &stream->chunks[engine_chunk_coord(y, stream->start_y) * stream->chunks_x + engine_chunk_coord(x, stream->start_x)];
+}
+
+static int engine_chunk_offset(struct TileStream* stream, int x, int y) {
+    return (y - stream->start_y) % CHUNK_SIZE * CHUNK_SIZE + (x - stream->start_x) % CHUNK_SIZE;
+}
+
+static void engine_chunk_origin(struct TileStream* stream, int index, int* x, int* y) {
+    *x = stream->start_x + index % stream->chunks_x * CHUNK_SIZE;
+    *y = stream->start_y + index / stream->chunks_x * CHUNK_SIZE;
+}
+
+static uint8_t* engine_decode_chunk(struct TileStream* stream, int origin_x, int origin_y) {
+    uint8_t* tiles = calloc(CHUNK_SIZE * CHUNK_SIZE, 1);
+    engine_level_decode(stream->asset, origin_x, origin_y, origin_x + CHUNK_SIZE, origin_y + CHUNK_SIZE, tiles, CHUNK_SIZE);
+    return tiles;
+}
+
+static void* engine_stream_worker(void* data) {
+    struct TileStream* stream = data;
+    pthread_mutex_lock(&stream->lock);
+    while (true) {
+        while (!stream->quit && stream->num_requests == 0) pthread_cond_wait(&stream->wake, &stream->lock);
+        if (stream->quit) break;
+        int chunk = stream->requests[--stream->num_requests];
+        int x, y;
+        engine_chunk_origin(stream, chunk, &x, &y);
+        pthread_mutex_unlock(&stream->lock);
+        uint8_t* tiles = engine_decode_chunk(stream, x, y);
+        pthread_mutex_lock(&stream->lock);
+        if (stream->num_done == stream->done_capacity) {
+            stream->done_capacity = stream->done_capacity == 0 ? 16 : stream->done_capacity * 2;
+            stream->done = realloc(stream->done, sizeof(ChunkJob) * stream->done_capacity);
+        }
+        stream->done[stream->num_done++] = (ChunkJob){ chunk, tiles };
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return NULL;
+}
+
+static void engine_chunk_save(Chunk* chunk, uint8_t* tiles) {
+    free(chunk->saved);
+    chunk->saved = malloc(CHUNK_SIZE * CHUNK_SIZE * 2);
+    chunk->saved_size = 0;
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE;) {
+        uint8_t tile = tiles[i];
+        int count = 0;
+        while (i < CHUNK_SIZE * CHUNK_SIZE && tiles[i] == tile && count < 255) i++, count++;
+        chunk->saved[chunk->saved_size++] = count;
+        chunk->saved[chunk->saved_size++] = tile;
+    }
+    chunk->saved = realloc(chunk->saved, chunk->saved_size);
+}
+
+static uint8_t* engine_chunk_restore(Chunk* chunk) {
+    uint8_t* tiles = malloc(CHUNK_SIZE * CHUNK_SIZE);
+    for (int i = 0, offset = 0; i < chunk->saved_size; i += 2) {
+        memset(tiles + offset, chunk->saved[i + 1], chunk->saved[i]);
+        offset += chunk->saved[i];
+    }
+    return tiles;
+}
+
+// decorators see the chunk as if the map was decorated in scan order, but only over what is resident.
+// writes past the chunk edge into chunks that aren't loaded are dropped instead of paging those in,
+// and the chunk is marked dirty so paging it out and back in doesn't decorate it again
+static void engine_chunk_decorate(TilemapNode* tilemap, int index) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = &stream->chunks[index];
+    int origin_x, origin_y;
+    engine_chunk_origin(stream, index, &origin_x, &origin_y);
+    int max_x = origin_x + CHUNK_SIZE < stream->end_x ? origin_x + CHUNK_SIZE : stream->end_x;
+    int max_y = origin_y + CHUNK_SIZE < stream->end_y ? origin_y + CHUNK_SIZE : stream->end_y;
+    stream->decorating = true;
+    for (; chunk->decorated < stream->num_decorators; chunk->decorated++) {
+        Decorator* decorator = &stream->decorators[chunk->decorated];
+        for (int y = origin_y; y < max_y; y++) for (int x = origin_x; x < max_x; x++) {
+            engine_count_call(decorator->func);
+            uint8_t tile = decorator->func(tilemap, x, y, decorator->data);
+            chunk->tiles[engine_chunk_offset(stream, x, y)] = tile;
+        }
+        chunk->dirty = true;
+    }
+    stream->decorating = false;
+}
+
+static void engine_chunk_page_in(TilemapNode* tilemap, int index, uint8_t* tiles) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = &stream->chunks[index];
+    if (chunk->saved) {
+        // the level asset is stale for this chunk, the modified copy wins
+        free(tiles);
+        tiles = engine_chunk_restore(chunk);
+    }
+    chunk->tiles = tiles;
+    chunk->state = ChunkState_Resident;
+    chunk->last_used = stream->frame;
+    stream->resident++;
+    engine_chunk_decorate(tilemap, index);
+    for (int i = 0; i < chunk->num_parked; i++) engine_attach_node(&tilemap->node, chunk->parked[i]);
+    chunk->num_parked = 0;
+    if (chunk->spawned || !stream->spawn) return;
+    chunk->spawned = true;
+    for (int i = 0; i < chunk->num_spawns; i++) {
+        float x, y;
+        const char* func = engine_level_spawn(stream->asset, chunk->spawns[i], &x, &y);
+        Node* node = stream->spawn(func, x, y);
+        if (node) engine_attach_node(&tilemap->node, node);
+    }
+}
+
+static void engine_chunk_page_out(TilemapNode* tilemap, int index) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = &stream->chunks[index];
+    for (int i = 0; i < tilemap->node.children_size; i++) {
+        Node* child = tilemap->node.children[i];
+        if (!child || child->type != NodeType_Entity) continue;
+        EntityNode* entity = (EntityNode*)child;
+        if (engine_get_chunk(stream, floorf(entity->pos_x), floorf(entity->pos_y)) != chunk) continue;
+        engine_detach_node(child);
+        if (chunk->num_parked == chunk->parked_capacity) {
+            chunk->parked_capacity = chunk->parked_capacity == 0 ? 4 : chunk->parked_capacity * 2;
+            chunk->parked = realloc(chunk->parked, sizeof(Node*) * chunk->parked_capacity);
+        }
+        chunk->parked[chunk->num_parked++] = child;
+    }
+    if (chunk->dirty) engine_chunk_save(chunk, chunk->tiles);
+    chunk->dirty = false;
+    free(chunk->tiles);
+    chunk->tiles = NULL;
+    chunk->state = ChunkState_Paged;
+    stream->resident--;
+}
+
+static void engine_chunk_request(struct TileStream* stream, int index) {
+    Chunk* chunk = &stream->chunks[index];
+    if (chunk->state != ChunkState_Paged) return;
+    chunk->state = ChunkState_Pending;
+    stream->pending++;
+    pthread_mutex_lock(&stream->lock);
+    if (stream->num_requests == stream->requests_capacity) {
+        stream->requests_capacity = stream->requests_capacity == 0 ? 16 : stream->requests_capacity * 2;
+        stream->requests = realloc(stream->requests, sizeof(int) * stream->requests_capacity);
+    }
+    stream->requests[stream->num_requests++] = index;
+    pthread_cond_signal(&stream->wake);
+    pthread_mutex_unlock(&stream->lock);
+}
+
+static Chunk* engine_chunk_load_now(TilemapNode* tilemap, int index) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = &stream->chunks[index];
+    if (chunk->state == ChunkState_Resident) return chunk;
+    int x, y;
+    engine_chunk_origin(stream, index, &x, &y);
+    // a pending request is left alone, its result gets dropped once it arrives
+    engine_chunk_page_in(tilemap, index, engine_decode_chunk(stream, x, y));
+    return chunk;
+}
+
+static void engine_stream_collect(TilemapNode* tilemap) {
+    struct TileStream* stream = tilemap->stream;
+    pthread_mutex_lock(&stream->lock);
+    int num_done = stream->num_done;
+    ChunkJob done[num_done + 1];
+    if (num_done) memcpy(done, stream->done, sizeof(ChunkJob) * num_done);
+    stream->num_done = 0;
+    pthread_mutex_unlock(&stream->lock);
+    for (int i = 0; i < num_done; i++) {
+        stream->pending--;
+        if (stream->chunks[done[i].chunk].state != ChunkState_Pending) free(done[i].tiles);
+        else engine_chunk_page_in(tilemap, done[i].chunk, done[i].tiles);
+    }
+}
+
+static struct TileStream* engine_new_stream(TilemapNode* tilemap, LevelAsset* asset, int budget, int fallback_tile, Node*(*spawn)(const char* func, float x, float y)) {
+    struct TileStream* stream = calloc(sizeof(struct TileStream), 1);
+    stream->asset = asset;
+    stream->spawn = spawn;
+    stream->fallback_tile = fallback_tile;
+    stream->budget = budget;
+    engine_level_bounds(asset, &stream->start_x, &stream->start_y, &stream->end_x, &stream->end_y);
+    stream->chunks_x = (stream->end_x - stream->start_x + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    stream->chunks_y = (stream->end_y - stream->start_y + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    stream->chunks = calloc(sizeof(Chunk), stream->chunks_x * stream->chunks_y + 1);
+    int num_spawns = engine_level_num_spawns(asset);
+    for (int i = 0; i < num_spawns && stream->chunks_x * stream->chunks_y > 0; i++) {
+        float x, y;
+        engine_level_spawn(asset, i, &x, &y);
+        int tx = floorf(x), ty = floorf(y);
+        // spawns outside of the map go to the nearest chunk
+        if (tx < stream->start_x) tx = stream->start_x;
+        if (ty < stream->start_y) ty = stream->start_y;
+        if (tx >= stream->end_x) tx = stream->end_x - 1;
+        if (ty >= stream->end_y) ty = stream->end_y - 1;
+        Chunk* chunk = engine_get_chunk(stream, tx, ty);
+        chunk->spawns = realloc(chunk->spawns, sizeof(int) * (chunk->num_spawns + 1));
+        chunk->spawns[chunk->num_spawns++] = i;
+    }
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->wake, NULL);
+    pthread_create(&stream->thread, NULL, engine_stream_worker, stream);
+    free(tilemap->tiles);
+    tilemap->tiles = NULL;
+    tilemap->start_x = stream->start_x;
+    tilemap->start_y = stream->start_y;
+    tilemap->end_x = stream->end_x;
+    tilemap->end_y = stream->end_y;
+    tilemap->stream = stream;
+    return stream;
+}
+
+void engine_stream_tilemap(TilemapNode* tilemap, LevelAsset* asset, int budget, int fallback_tile, Node*(*spawn)(const char* func, float x, float y), float focus_x, float focus_y) {
+    engine_free_stream(tilemap);
+    engine_new_stream(tilemap, asset, budget, fallback_tile, spawn);
+    int x = floorf(focus_x), y = floorf(focus_y);
+    engine_stream_view(tilemap, x, y, x + 1, y + 1);
+    engine_stream_update(tilemap);
+}
+
+void engine_stream_view(TilemapNode* tilemap, int min_x, int min_y, int max_x, int max_y) {
+    struct TileStream* stream = tilemap->stream;
+    int cx1 = floorf((float)(min_x - stream->start_x) / CHUNK_SIZE);
+    int cy1 = floorf((float)(min_y - stream->start_y) / CHUNK_SIZE);
+    int cx2 = floorf((float)(max_x - 1 - stream->start_x) / CHUNK_SIZE);
+    int cy2 = floorf((float)(max_y - 1 - stream->start_y) / CHUNK_SIZE);
+    stream->view_min_x = cx1 < 0 ? 0 : cx1;
+    stream->view_min_y = cy1 < 0 ? 0 : cy1;
+    stream->view_max_x = cx2 >= stream->chunks_x ? stream->chunks_x - 1 : cx2;
+    stream->view_max_y = cy2 >= stream->chunks_y ? stream->chunks_y - 1 : cy2;
+}
+
+static bool engine_chunk_in_rect(struct TileStream* stream, int index, int margin) {
+    int cx = index % stream->chunks_x, cy = index / stream->chunks_x;
+    return
+        cx >= stream->view_min_x - margin && cx <= stream->view_max_x + margin &&
+        cy >= stream->view_min_y - margin && cy <= stream->view_max_y + margin;
+}
+
+void engine_stream_update(TilemapNode* tilemap) {
+    struct TileStream* stream = tilemap->stream;
+    stream->frame++;
+    engine_stream_collect(tilemap);
+    for (int cy = stream->view_min_y - PREFETCH_MARGIN; cy <= stream->view_max_y + PREFETCH_MARGIN; cy++) {
+        for (int cx = stream->view_min_x - PREFETCH_MARGIN; cx <= stream->view_max_x + PREFETCH_MARGIN; cx++) {
+            if (cx < 0 || cy < 0 || cx >= stream->chunks_x || cy >= stream->chunks_y) continue;
+            int index = cy * stream->chunks_x + cx;
+            bool visible = cx >= stream->view_min_x && cx <= stream->view_max_x && cy >= stream->view_min_y && cy <= stream->view_max_y;
+            if (visible) engine_chunk_load_now(tilemap, index);
+            else if (stream->resident + stream->pending < stream->budget) engine_chunk_request(stream, index);
+            stream->chunks[index].last_used = stream->frame;
+        }
+    }
+    // least recently used chunks go first, the visible ones always stay
+    while (stream->resident > stream->budget) {
+        int victim = -1;
+        for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+            Chunk* chunk = &stream->chunks[i];
+            if (chunk->state != ChunkState_Resident || engine_chunk_in_rect(stream, i, 0)) continue;
+            if (victim == -1 || chunk->last_used < stream->chunks[victim].last_used) victim = i;
+        }
+        if (victim == -1) break;
+        engine_chunk_page_out(tilemap, victim);
+    }
+}
+
+uint8_t engine_stream_get_tile(TilemapNode* tilemap, int x, int y) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = engine_get_chunk(stream, x, y);
+    if (!chunk || chunk->state != ChunkState_Resident) {
+        if (chunk && stream->fallback_tile >= 0) return stream->fallback_tile;
+        engine_count_call(tilemap->oob_tile_provider);
+        return tilemap->oob_tile_provider(tilemap, x, y);
+    }
+    return chunk->tiles[engine_chunk_offset(stream, x, y)];
+}
+
+void engine_stream_set_tile(TilemapNode* tilemap, int x, int y, uint8_t tile) {
+    struct TileStream* stream = tilemap->stream;
+    Chunk* chunk = engine_get_chunk(stream, x, y);
+    if (!chunk) return; // streamed maps don't grow
+    if (stream->decorating && chunk->state != ChunkState_Resident) return;
+    engine_chunk_load_now(tilemap, chunk - stream->chunks);
+    chunk->tiles[engine_chunk_offset(stream, x, y)] = tile;
+    chunk->dirty = true;
+}
+
+static void engine_stop_worker(struct TileStream* stream) {
+    pthread_mutex_lock(&stream->lock);
+    stream->quit = true;
+    pthread_cond_signal(&stream->wake);
+    pthread_mutex_unlock(&stream->lock);
+    pthread_join(stream->thread, NULL);
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->wake);
+}
+
+void engine_free_stream(TilemapNode* tilemap) {
+    struct TileStream* stream = tilemap->stream;
+    if (!stream) return;
+    engine_stop_worker(stream);
+    for (int i = 0; i < stream->num_done; i++) free(stream->done[i].tiles);
+    for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+        Chunk* chunk = &stream->chunks[i];
+        for (int j = 0; j < chunk->num_parked; j++) engine_delete_node(chunk->parked[j]);
+        free(chunk->parked);
+        free(chunk->spawns);
+        free(chunk->saved);
+        free(chunk->tiles);
+    }
+    free(stream->decorators);
+    free(stream->chunks);
+    free(stream->requests);
+    free(stream->done);
+    free(stream);
+    tilemap->stream = NULL;
+}
+
+// runs func over every chunk the first time it becomes resident, like engine_map_tiles over the whole map would
+void engine_stream_decorate(TilemapNode* tilemap, uint8_t(*func)(TilemapNode* tilemap, int x, int y, void* data), void* data) {
+    struct TileStream* stream = tilemap->stream;
+    stream->decorators = realloc(stream->decorators, sizeof(Decorator) * (stream->num_decorators + 1));
+    stream->decorators[stream->num_decorators++] = (Decorator){ func, data };
+    for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+        if (stream->chunks[i].state == ChunkState_Resident) engine_chunk_decorate(tilemap, i);
+    }
+}
+
+// the whole map as it is now: resident chunks, edits of paged out chunks, and the asset for the rest
+uint8_t* engine_stream_snapshot(TilemapNode* tilemap) {
+    struct TileStream* stream = tilemap->stream;
+    int width = stream->end_x - stream->start_x;
+    uint8_t* out = malloc((size_t)width * (stream->end_y - stream->start_y) + 1);
+    for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+        Chunk* chunk = &stream->chunks[i];
+        int origin_x, origin_y;
+        engine_chunk_origin(stream, i, &origin_x, &origin_y);
+        uint8_t* tiles = chunk->state == ChunkState_Resident ? chunk->tiles : chunk->saved ? engine_chunk_restore(chunk) : engine_decode_chunk(stream, origin_x, origin_y);
+        int columns = origin_x + CHUNK_SIZE < stream->end_x ? CHUNK_SIZE : stream->end_x - origin_x;
+        int rows = origin_y + CHUNK_SIZE < stream->end_y ? CHUNK_SIZE : stream->end_y - origin_y;
+        for (int y = 0; y < rows; y++) {
+            memcpy(out + (size_t)(origin_y - stream->start_y + y) * width + (origin_x - stream->start_x), tiles + y * CHUNK_SIZE, columns);
+        }
+        if (tiles != chunk->tiles) free(tiles);
+    }
+    return out;
+}
+
+// entities that aren't children of the tilemap right now: parked ones and spawns of chunks that never loaded
+void engine_stream_spawns(TilemapNode* tilemap, void(*callback)(float x, float y, const char* func, void* data), void* data) {
+    struct TileStream* stream = tilemap->stream;
+    for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+        Chunk* chunk = &stream->chunks[i];
+        for (int j = 0; j < chunk->num_parked; j++) {
+            if (chunk->parked[j]->type != NodeType_Entity) continue;
+            EntityNode* entity = (EntityNode*)chunk->parked[j];
+            if (entity->func) callback(entity->pos_x, entity->pos_y, entity->func, data);
+        }
+        if (chunk->spawned) continue;
+        for (int j = 0; j < chunk->num_spawns; j++) {
+            float x, y;
+            const char* func = engine_level_spawn(stream->asset, chunk->spawns[j], &x, &y);
+            callback(x, y, func, data);
+        }
+    }
+}
+
+// called once the children have been copied, entities of resident chunks came along with them
+void engine_copy_stream(TilemapNode* copy, TilemapNode* orig) {
+    struct TileStream* stream = orig->stream;
+    struct TileStream* copied = engine_new_stream(copy, stream->asset, stream->budget, stream->fallback_tile, stream->spawn);
+    copied->view_min_x = stream->view_min_x;
+    copied->view_min_y = stream->view_min_y;
+    copied->view_max_x = stream->view_max_x;
+    copied->view_max_y = stream->view_max_y;
+    copied->num_decorators = stream->num_decorators;
+    copied->decorators = memcpy(malloc(sizeof(Decorator) * (stream->num_decorators + 1)), stream->decorators, sizeof(Decorator) * stream->num_decorators);
+    for (int i = 0; i < stream->chunks_x * stream->chunks_y; i++) {
+        Chunk* from = &stream->chunks[i];
+        Chunk* to = &copied->chunks[i];
+        to->spawned = from->spawned;
+        to->decorated = from->decorated;
+        if (from->state == ChunkState_Resident && from->dirty) engine_chunk_save(to, from->tiles);
+        else if (from->saved) {
+            to->saved = memcpy(malloc(from->saved_size), from->saved, from->saved_size);
+            to->saved_size = from->saved_size;
+        }
+        to->num_parked = to->parked_capacity = from->num_parked;
+        to->parked = malloc(sizeof(Node*) * (from->num_parked + 1));
+        for (int j = 0; j < from->num_parked; j++) to->parked[j] = engine_deep_copy(from->parked[j]);
+    }
+    engine_stream_update(copy);
+}
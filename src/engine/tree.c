@@ -5,6 +5,30 @@
 
 static Node deleted_nodes;
 
+static TilesetNode* engine_find_tileset(TilemapNode* tilemap) {
+    for (int i = 0; i < tilemap->node.children_size; i++) {
+        if (!tilemap->node.children[i]) continue;
+        if (tilemap->node.children[i]->type != NodeType_Tileset) continue;
+        return (TilesetNode*)tilemap->node.children[i];
+    }
+    return NULL;
+}
+
+static void engine_update_caches(Node* parent, Node* child, int index) {
+    if (parent->type == NodeType_Tilemap && child->type == NodeType_Entity) {
+        if (child->parent == parent) engine_spatial_insert((TilemapNode*)parent, index, (EntityNode*)child);
+        else engine_spatial_remove((TilemapNode*)parent, index);
+    }
+    if (parent->type == NodeType_Tilemap && child->type == NodeType_Tileset) {
+        TilemapNode* tilemap = (TilemapNode*)parent;
+        tilemap->cached_tileset = engine_find_tileset(tilemap);
+        if (tilemap->cached_tileset == child && child->parent == parent) engine_build_tileset_cache((TilesetNode*)child);
+    }
+    if (parent->type == NodeType_Tileset) engine_invalidate_tileset_cache((TilesetNode*)parent);
+    if (parent->type == NodeType_Tile && parent->parent && parent->parent->type == NodeType_Tileset)
+        engine_invalidate_tileset_cache((TilesetNode*)parent->parent);
+}
+
 static void engine_mark_deleted(Node* node) {
     for (int i = 0; i < node->children_size; i++) {
         if (!node->children[i]) continue;
@@ -19,6 +43,7 @@ void engine_attach_node(Node* parent, Node* child) {
     for (int i = 0; i < parent->children_size; i++) {
         if (parent->children[i] == NULL) {
             parent->children[i] = child;
+            engine_update_caches(parent, child, i);
             return;
         }
     }
@@ -28,17 +53,21 @@ void engine_attach_node(Node* parent, Node* child) {
         parent->children = realloc(parent->children, sizeof(Node*) * parent->children_capacity);
     }
     parent->children[parent->children_size++] = child;
+    engine_update_caches(parent, child, parent->children_size - 1);
 }
 
 void engine_detach_node(Node* child) {
     if (!child->parent) return;
-    for (int i = 0; i < child->parent->children_size; i++) {
-        if (child->parent->children[i] == child) {
-            child->parent->children[i] = NULL;
+    Node* parent = child->parent;
+    int index = 0;
+    for (; index < parent->children_size; index++) {
+        if (parent->children[index] == child) {
+            parent->children[index] = NULL;
             break;
         }
     }
     child->parent = NULL;
+    engine_update_caches(parent, child, index);
 }
 
 void engine_delete_node(Node* node) {
@@ -52,7 +81,10 @@ Node* engine_deep_copy(Node* node) {
         TilemapNode* tilemap = (TilemapNode*)copy;
         TilemapNode* orig = (TilemapNode*)node;
         int size = (orig->end_x - orig->start_x) * (orig->end_y - orig->start_y);
-        tilemap->tiles = memcpy(malloc(size), orig->tiles, size);
+        tilemap->tiles = orig->tiles ? memcpy(malloc(size), orig->tiles, size) : NULL;
+        tilemap->collision_mask = NULL;
+        tilemap->spatial_index = NULL;
+        tilemap->stream = NULL;
     }
     if (copy->type == NodeType_Entity) {
         EntityNode* entity = (EntityNode*)copy;
@@ -71,14 +103,29 @@ Node* engine_deep_copy(Node* node) {
         child->parent = copy;
         copy->children[i] = child;
     }
+    if (copy->type == NodeType_Tileset) {
+        TilesetNode* tileset = (TilesetNode*)copy;
+        tileset->cache = NULL;
+        if (((TilesetNode*)node)->cache) engine_build_tileset_cache(tileset);
+    }
+    if (copy->type == NodeType_Tilemap) {
+        ((TilemapNode*)copy)->cached_tileset = engine_find_tileset((TilemapNode*)copy);
+        if (((TilemapNode*)node)->stream) engine_copy_stream((TilemapNode*)copy, (TilemapNode*)node);
+    }
     return copy;
 }
 
 void engine_cleanup() {
     for (int i = 0; i < deleted_nodes.children_size; i++) {
         Node* node = deleted_nodes.children[i];
-        if (node->type == NodeType_Tilemap) free(((TilemapNode*)node)->tiles);
+        if (node->type == NodeType_Tilemap) {
+            free(((TilemapNode*)node)->tiles);
+            engine_free_collision_mask((TilemapNode*)node);
+            engine_free_spatial_index((TilemapNode*)node);
+            engine_free_stream((TilemapNode*)node);
+        }
         if (node->type == NodeType_Entity) free(((EntityNode*)node)->data.entries);
+        if (node->type == NodeType_Tileset) free(((TilesetNode*)node)->cache);
         free(node->children);
         free(node);
     }
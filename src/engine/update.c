@@ -3,12 +3,8 @@
 #include <stddef.h>
 
 TilesetNode* engine_get_tileset(TilemapNode* tilemap) {
-    TilesetNode* tileset = NULL;
-    for (int i = 0; i < tilemap->node.children_size && !tileset; i++) {
-        if (!tilemap->node.children[i]) continue;
-        if (tilemap->node.children[i]->type != NodeType_Tileset) continue;
-        tileset = (TilesetNode*)tilemap->node.children[i];
-    }
+    TilesetNode* tileset = tilemap->cached_tileset;
+    if (tileset && (!tileset->cache || tileset->cache->dirty)) engine_build_tileset_cache(tileset);
     return tileset;
 }
 
@@ -16,6 +12,7 @@ static void engine_collision_event(Node* node, EntityNode* entity, TilemapNode*
     for (int i = 0; i < node->children_size; i++) {
         if (!node->children[i]) continue;
         if (node->children[i]->type != NodeType_Collision) continue;
+        engine_count_call(((CollisionNode*)node->children[i])->func);
         ((CollisionNode*)node->children[i])->func(entity, tilemap, tile, x, y, dir);
     }
 }
@@ -33,13 +30,18 @@ static bool engine_rect_intersect(
 }
 
 static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, TilesetNode* tileset, Axis axis, float delta_time) {
-    if (entity->width == 0 && entity->height == 0) {
+    if ((entity->width == 0 && entity->height == 0) || !tileset) {
         if (axis == Axis_X) entity->pos_x += entity->vel_x * delta_time;
         else entity->pos_y += entity->vel_y * delta_time;
         return;
     }
     float delta = axis == Axis_X ? entity->vel_x * delta_time : entity->vel_y * delta_time;
     int steps = ceilf(fabsf(delta));
+    bool has_collision_handler = false;
+    for (int i = 0; i < entity->node.children_size && !has_collision_handler; i++) {
+        if (!entity->node.children[i]) continue;
+        if (entity->node.children[i]->type == NodeType_Collision) has_collision_handler = true;
+    }
     for (int step = 0; step < steps; step++) {
         *(axis == Axis_X ? &entity->pos_x : &entity->pos_y) += delta / steps;
 
@@ -51,11 +53,15 @@ static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, Til
         int min_y = floorf(fy) - 1;
         int max_x = ceilf(tx) + 1;
         int max_y = ceilf(ty) + 1;
+        if (!has_collision_handler && !engine_check_tiles(tilemap, min_x, min_y, max_x + 1, max_y + 1,
+            CollisionFlag_Solid | CollisionFlag_TopOnly | CollisionFlag_Event
+        )) continue;
         for (int y = min_y; y <= max_y; y++) {
             for (int x = min_x; x <= max_x; x++) {
-                TileNode* tile = (TileNode*)tileset->node.children[engine_get_tile(tilemap, x, y)];
-                bool solid = tile->collision == Collision_Solid;
                 if (!engine_rect_intersect(fx, fy, tx, ty, x, y, x + 1, y + 1)) continue;
+                TileInfo* info = &tileset->cache->tiles[engine_get_tile(tilemap, x, y)];
+                TileNode* tile = info->tile;
+                bool solid = info->collision == Collision_Solid;
                 if (axis == Axis_X) {
                     if (entity->vel_x == 0) (void)0;
                     else if (entity->vel_x > 0) {
@@ -63,7 +69,7 @@ static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, Til
                             entity->pos_x = x - entity->width / 2;
                             *(Direction*)engine_property(entity, "hor_collision") = Direction_Right;
                         }
-                        engine_collision_event((Node*)tile,   entity, tilemap, tile, x, y, Direction_Left);
+                        if (info->has_collision_handler) engine_collision_event((Node*)tile, entity, tilemap, tile, x, y, Direction_Left);
                         engine_collision_event((Node*)entity, entity, tilemap, tile, x, y, Direction_Right);
                     }
                     else if (entity->vel_x < 0) {
@@ -71,7 +77,7 @@ static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, Til
                             entity->pos_x = x + 1 + entity->width / 2;
                             *(Direction*)engine_property(entity, "hor_collision") = Direction_Left;
                         }
-                        engine_collision_event((Node*)tile,   entity, tilemap, tile, x, y, Direction_Right);
+                        if (info->has_collision_handler) engine_collision_event((Node*)tile, entity, tilemap, tile, x, y, Direction_Right);
                         engine_collision_event((Node*)entity, entity, tilemap, tile, x, y, Direction_Left);
                     }
                     if (solid) {
@@ -80,14 +86,14 @@ static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, Til
                     }
                 }
                 if (axis == Axis_Y) {
-                    solid = tile->collision == Collision_Solid || (tile->collision == Collision_TopOnly && entity->vel_y > 0 && entity->prev_pos_y <= y);
+                    solid = info->collision == Collision_Solid || (info->collision == Collision_TopOnly && entity->vel_y > 0 && entity->prev_pos_y <= y);
                     if (entity->vel_y == 0) (void)0;
                     else if (entity->vel_y > 0) {
                         if (solid) {
                             entity->pos_y = y;
                             *(Direction*)engine_property(entity, "ver_collision") = Direction_Down;
                         }
-                        engine_collision_event((Node*)tile,   entity, tilemap, tile, x, y, Direction_Up);
+                        if (info->has_collision_handler) engine_collision_event((Node*)tile, entity, tilemap, tile, x, y, Direction_Up);
                         engine_collision_event((Node*)entity, entity, tilemap, tile, x, y, Direction_Down);
                     }
                     else if (entity->vel_y < 0) {
@@ -95,7 +101,7 @@ static void engine_update_position(EntityNode* entity, TilemapNode* tilemap, Til
                             entity->pos_y = y + 1 + entity->height;
                             *(Direction*)engine_property(entity, "ver_collision") = Direction_Up;
                         }
-                        engine_collision_event((Node*)tile,   entity, tilemap, tile, x, y, Direction_Down);
+                        if (info->has_collision_handler) engine_collision_event((Node*)tile, entity, tilemap, tile, x, y, Direction_Down);
                         engine_collision_event((Node*)entity, entity, tilemap, tile, x, y, Direction_Up);
                     }
                     if (solid) {
@@ -113,6 +119,7 @@ static void engine_update_entity(EntityNode* entity, TilemapNode* tilemap, Tiles
     for (int i = 0; i < entity->node.children_size; i++) {
         if (!entity->node.children[i]) continue;
         if (entity->node.children[i]->type != NodeType_EntityUpdate) continue;
+        engine_count_call(((EntityUpdateNode*)entity->node.children[i])->func);
         ((EntityUpdateNode*)entity->node.children[i])->func(entity, tilemap, delta_time);
         if (!tilemap->node.children[index]) return; // entity deleted
     }
@@ -133,6 +140,7 @@ static void engine_update_entity(EntityNode* entity, TilemapNode* tilemap, Tiles
         ) for (int i = 0; i < entity->node.children_size; i++) {
             if (!entity->node.children[i]) continue;
             if (entity->node.children[i]->type != NodeType_EntityCollision) continue;
+            engine_count_call(((EntityCollisionNode*)entity->node.children[i])->func);
             ((EntityCollisionNode*)entity->node.children[i])->func(entity, collider, tilemap);
             if (!tilemap->node.children[index]) return; // entity deleted
         }
@@ -142,9 +150,11 @@ static void engine_update_entity(EntityNode* entity, TilemapNode* tilemap, Tiles
     *(float*)engine_property(entity, "timer") += delta_time;
     entity->prev_pos_x = entity->pos_x;
     entity->prev_pos_y = entity->pos_y;
+    engine_spatial_move(tilemap, index, entity);
 }
 
 static void engine_update_tilemap(TilemapNode* tilemap, TilesetNode* tileset, float delta_time) {
+    if (tilemap->stream) engine_stream_update(tilemap);
     for (int i = 0; i < tilemap->node.children_size; i++) {
         if (!tilemap->node.children[i]) continue;
         if (tilemap->node.children[i]->type != NodeType_Entity) continue;
@@ -154,6 +164,7 @@ static void engine_update_tilemap(TilemapNode* tilemap, TilesetNode* tileset, fl
 }
 
 void engine_update(LevelRootNode* node, float delta_time) {
+    engine_record_frame();
     for (int i = 0; i < node->node.children_size; i++) {
         if (!node->node.children[i]) continue;
         if (node->node.children[i]->type != NodeType_Tilemap) continue;
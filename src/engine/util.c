@@ -7,39 +7,206 @@ static int compare_string(const void* a, const void* b) {
     return strcmp(*(char**)a, *(char**)b);
 }
 
-void engine_set_tile(TilemapNode* node, int x, int y, uint8_t tile) {
-    if (x < node->start_x || y < node->start_y || x >= node->end_x || y >= node->end_y || !node->tiles) {
-        int growth_left = 0, growth_right = 0, growth_top = 0, growth_bottom = 0;
-        if (x < node->start_x) growth_left  = (node->start_x - x + 16) / 16 * 16;
-        if (y < node->start_y) growth_top   = (node->start_y - y + 16) / 16 * 16;
-        if (x >= node->end_x)  growth_right  = (x -  node->end_x + 16) / 16 * 16;
-        if (y >= node->end_y)  growth_bottom = (y -  node->end_y + 16) / 16 * 16;
-        int old_start_x = node->start_x, old_start_y = node->start_y, old_end_x = node->end_x, old_end_y = node->end_y;
-        node->start_x -= growth_left;
-        node->start_y -= growth_top;
-        node->end_x += growth_right;
-        node->end_y += growth_bottom;
-        int pitch = node->end_x - node->start_x;
-        int old_pitch = old_end_x - old_start_x;
-        size_t size = (node->end_x - node->start_x) * (node->end_y - node->start_y);
-        uint8_t* new_tiles = malloc(size);
-        memset(new_tiles, 0, size);
-        if (node->tiles) for (int y = old_start_y; y < old_end_y; y++)
-            for (int x = old_start_x; x < old_end_x; x++)
-                new_tiles[(y - node->start_y) * pitch + (x - node->start_x)] = node->tiles[(y - old_start_y) * old_pitch + (x - old_start_x)];
-        free(node->tiles);
-        node->tiles = new_tiles;
+void engine_build_tileset_cache(TilesetNode* tileset) {
+    static unsigned generation;
+    if (!tileset->cache) tileset->cache = malloc(sizeof(struct TilesetCache));
+    struct TilesetCache* cache = tileset->cache;
+    memset(cache, 0, sizeof(struct TilesetCache));
+    cache->generation = ++generation;
+    for (int i = 0; i < tileset->node.children_size && i < 256; i++) {
+        if (!tileset->node.children[i]) continue;
+        if (tileset->node.children[i]->type != NodeType_Tile) continue;
+        TileNode* tile = (TileNode*)tileset->node.children[i];
+        TileInfo* info = &cache->tiles[i];
+        info->tile = tile;
+        info->collision = tile->collision;
+        for (int j = 0; j < tile->node.children_size; j++) {
+            if (!tile->node.children[j]) continue;
+            if (tile->node.children[j]->type == NodeType_Collision) info->has_collision_handler = true;
+            if (tile->node.children[j]->type != NodeType_TileTexture) continue;
+            if (info->texture) info->has_multiple_textures = true;
+            else info->texture = ((TileTextureNode*)tile->node.children[j])->func;
+        }
     }
+    int tiles_per_row = tileset->tiles_per_row > 0 ? tileset->tiles_per_row : 1;
+    for (int i = 0; i < 256; i++) {
+        cache->src[i].x = (i % tiles_per_row) * tileset->tile_width;
+        cache->src[i].y = (i / tiles_per_row) * tileset->tile_height;
+    }
+}
+
+void engine_invalidate_tileset_cache(TilesetNode* tileset) {
+    if (tileset->cache) tileset->cache->dirty = true;
+}
+
+static void engine_grow_tilemap(TilemapNode* node, int min_x, int min_y, int max_x, int max_y) {
+    if (min_x >= node->start_x && min_y >= node->start_y && max_x <= node->end_x && max_y <= node->end_y && node->tiles) return;
+    int growth_left = 0, growth_right = 0, growth_top = 0, growth_bottom = 0;
+    if (min_x < node->start_x) growth_left  = (node->start_x - min_x + 16) / 16 * 16;
+    if (min_y < node->start_y) growth_top   = (node->start_y - min_y + 16) / 16 * 16;
+    if (max_x > node->end_x)   growth_right  = (max_x - 1 - node->end_x + 16) / 16 * 16;
+    if (max_y > node->end_y)   growth_bottom = (max_y - 1 - node->end_y + 16) / 16 * 16;
+    int old_start_x = node->start_x, old_start_y = node->start_y, old_end_x = node->end_x, old_end_y = node->end_y;
+    node->start_x -= growth_left;
+    node->start_y -= growth_top;
+    node->end_x += growth_right;
+    node->end_y += growth_bottom;
     int pitch = node->end_x - node->start_x;
-    node->tiles[(y - node->start_y) * pitch + (x - node->start_x)] = tile;
+    int old_pitch = old_end_x - old_start_x;
+    size_t size = (node->end_x - node->start_x) * (node->end_y - node->start_y);
+    uint8_t* new_tiles = malloc(size);
+    memset(new_tiles, 0, size);
+    if (node->tiles) for (int y = old_start_y; y < old_end_y; y++)
+        memcpy(new_tiles + (y - node->start_y) * pitch + (old_start_x - node->start_x), node->tiles + (y - old_start_y) * old_pitch, old_pitch);
+    free(node->tiles);
+    node->tiles = new_tiles;
+}
+
+static uint8_t* engine_tile_ptr(TilemapNode* node, int x, int y) {
+    return node->tiles + (y - node->start_y) * (node->end_x - node->start_x) + (x - node->start_x);
+}
+
+void engine_set_tile(TilemapNode* node, int x, int y, uint8_t tile) {
+    if (node->stream) {
+        engine_stream_set_tile(node, x, y, tile);
+        return;
+    }
+    engine_grow_tilemap(node, x, y, x + 1, y + 1);
+    *engine_tile_ptr(node, x, y) = tile;
+    if (node->collision_mask) engine_update_collision_mask(node, x, y, tile);
+}
+
+void engine_fill_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t tile) {
+    if (min_x >= max_x || min_y >= max_y) return;
+    if (node->stream) {
+        for (int y = min_y; y < max_y; y++) for (int x = min_x; x < max_x; x++) engine_stream_set_tile(node, x, y, tile);
+        return;
+    }
+    engine_grow_tilemap(node, min_x, min_y, max_x, max_y);
+    for (int y = min_y; y < max_y; y++) memset(engine_tile_ptr(node, min_x, y), tile, max_x - min_x);
+    if (node->collision_mask) engine_update_collision_region(node, min_x, min_y, max_x, max_y);
+}
+
+void engine_map_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t(*func)(TilemapNode* tilemap, int x, int y, void* data), void* data) {
+    if (min_x >= max_x || min_y >= max_y) return;
+    if (node->stream) {
+        for (int y = min_y; y < max_y; y++) for (int x = min_x; x < max_x; x++) engine_stream_set_tile(node, x, y, func(node, x, y, data));
+        return;
+    }
+    engine_grow_tilemap(node, min_x, min_y, max_x, max_y);
+    // func may write other tiles (or grow the map), so results are stored one at a time in scan order
+    for (int y = min_y; y < max_y; y++) for (int x = min_x; x < max_x; x++) {
+        uint8_t tile = func(node, x, y, data); // before taking the pointer, node->tiles may move
+        *engine_tile_ptr(node, x, y) = tile;
+    }
+    if (node->collision_mask) engine_update_collision_region(node, min_x, min_y, max_x, max_y);
+}
+
+void engine_copy_tiles(TilemapNode* dst, int dst_x, int dst_y, TilemapNode* src, int min_x, int min_y, int max_x, int max_y) {
+    if (min_x >= max_x || min_y >= max_y) return;
+    int width = max_x - min_x, height = max_y - min_y;
+    // staged through a buffer so overlapping copies within one tilemap work, and growing dst can't invalidate src
+    uint8_t* buffer = malloc(width * height);
+    for (int y = 0; y < height; y++) {
+        int from = min_x, to = max_x, sy = min_y + y;
+        if (src->stream) {
+            for (int x = min_x; x < max_x; x++) buffer[y * width + (x - min_x)] = engine_stream_get_tile(src, x, sy);
+            continue;
+        }
+        if (src->tiles && sy >= src->start_y && sy < src->end_y) {
+            if (from < src->start_x) from = src->start_x;
+            if (to > src->end_x) to = src->end_x;
+        }
+        else from = to = max_x;
+        for (int x = min_x; x < max_x; x++) {
+            if (x == from && from < to) {
+                memcpy(buffer + y * width + (x - min_x), engine_tile_ptr(src, x, sy), to - from);
+                x = to - 1;
+            }
+            else buffer[y * width + (x - min_x)] = src->oob_tile_provider(src, x, sy);
+        }
+    }
+    if (dst->stream) {
+        for (int y = 0; y < height; y++) for (int x = 0; x < width; x++) engine_stream_set_tile(dst, dst_x + x, dst_y + y, buffer[y * width + x]);
+        free(buffer);
+        return;
+    }
+    engine_grow_tilemap(dst, dst_x, dst_y, dst_x + width, dst_y + height);
+    for (int y = 0; y < height; y++) memcpy(engine_tile_ptr(dst, dst_x, dst_y + y), buffer + y * width, width);
+    free(buffer);
+    if (dst->collision_mask) engine_update_collision_region(dst, dst_x, dst_y, dst_x + width, dst_y + height);
+}
+
+int engine_flood_fill(TilemapNode* node, int x, int y, uint8_t tile) {
+    if (!node->tiles || x < node->start_x || y < node->start_y || x >= node->end_x || y >= node->end_y) return 0;
+    int width = node->end_x - node->start_x, height = node->end_y - node->start_y;
+    x -= node->start_x;
+    y -= node->start_y;
+    uint8_t target = node->tiles[y * width + x];
+    if (target == tile) return 0;
+    int filled = 0;
+    int min_x = x, min_y = y, max_x = x + 1, max_y = y + 1;
+    int capacity = 64, count = 0;
+    struct { int x, y; }* stack = malloc(sizeof(*stack) * capacity);
+    stack[count].x = x;
+    stack[count].y = y;
+    count++;
+    while (count > 0) {
+        count--;
+        int sx = stack[count].x, sy = stack[count].y;
+        uint8_t* row = node->tiles + sy * width;
+        if (row[sx] != target) continue;
+        int left = sx, right = sx + 1;
+        while (left > 0 && row[left - 1] == target) left--;
+        while (right < width && row[right] == target) right++;
+        memset(row + left, tile, right - left);
+        filled += right - left;
+        if (left < min_x) min_x = left;
+        if (right > max_x) max_x = right;
+        if (sy < min_y) min_y = sy;
+        if (sy + 1 > max_y) max_y = sy + 1;
+        for (int ny = sy - 1; ny <= sy + 1; ny += 2) {
+            if (ny < 0 || ny >= height) continue;
+            uint8_t* next = node->tiles + ny * width;
+            // one seed per run of target tiles
+            for (int nx = left; nx < right; nx++) {
+                if (next[nx] != target || (nx > left && next[nx - 1] == target)) continue;
+                if (count == capacity) stack = realloc(stack, sizeof(*stack) * (capacity *= 2));
+                stack[count].x = nx;
+                stack[count].y = ny;
+                count++;
+            }
+        }
+    }
+    free(stack);
+    if (node->collision_mask) engine_update_collision_region(node,
+        node->start_x + min_x, node->start_y + min_y,
+        node->start_x + max_x, node->start_y + max_y
+    );
+    return filled;
 }
 
 uint8_t engine_get_tile(TilemapNode* node, int x, int y) {
-    if (x < node->start_x || y < node->start_y || x >= node->end_x || y >= node->end_y || !node->tiles) return node->oob_tile_provider(node, x, y);
+    if (node->stream) return engine_stream_get_tile(node, x, y);
+    if (x < node->start_x || y < node->start_y || x >= node->end_x || y >= node->end_y || !node->tiles) {
+        engine_count_call(node->oob_tile_provider);
+        return node->oob_tile_provider(node, x, y);
+    }
     int pitch = node->end_x - node->start_x;
     return node->tiles[(y - node->start_y) * pitch + (x - node->start_x)];
 }
 
+// reads a rect of tiles in row order, autotilers use this for their neighbourhood instead of one call per tile
+void engine_get_tiles(TilemapNode* node, int min_x, int min_y, int max_x, int max_y, uint8_t* out) {
+    int width = max_x - min_x;
+    if (width <= 0) return;
+    bool inside = node->tiles && !node->stream && min_x >= node->start_x && min_y >= node->start_y && max_x <= node->end_x && max_y <= node->end_y;
+    for (int y = min_y; y < max_y; y++, out += width) {
+        if (inside) memcpy(out, engine_tile_ptr(node, min_x, y), width);
+        else for (int x = min_x; x < max_x; x++) out[x - min_x] = engine_get_tile(node, x, y);
+    }
+}
+
 void* engine_property(EntityNode* node, const char* name) {
     if (node->data.entries) {
         void* ptr = bsearch(&name, node->data.entries, node->data.count, sizeof(*node->data.entries), compare_string);
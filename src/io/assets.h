@@ -2,6 +2,7 @@
 #define ASSETS_H
 
 void load_assets();
+void report_asset_times();
 void* _get_asset(const char* name);
 
 #define get_asset(type, name) (typeof(type)*)_get_asset(name)
@@ -1,14 +1,15 @@
 #include "loaders.h"
+#include "io/platform.h"
 
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-#ifdef _WIN32
-#define BINARY "b"
-#else
-#define BINARY
-#endif
+#define MAX_LOADER_THREADS 16
+#define SLOWEST_ASSETS 5
 
 typedef struct {
     const char* name;
@@ -22,8 +23,16 @@ typedef struct {
 typedef struct {
     const char* ext;
     void*(*loader)(const char* filename, uint8_t* data, int len);
+    bool mapped; // loader keeps pointers into the file, it stays mapped for the whole run
+    void(*finish)(void* data); // set for loaders that run on the worker pool, registers the result in asset order
 } Loader;
 
+typedef struct {
+    Asset* asset;
+    Loader* loader;
+    uint64_t micros; // reading and decoding the file
+} AssetJob;
+
 static Asset assets[] = {
 #ifdef CLANGD_IGNORE
 #include "data.h"
@@ -31,10 +40,18 @@ static Asset assets[] = {
 };
 
 static Loader loaders[] = {
-#define LOADER(ext) { #ext, loader_##ext },
+#define LOADER(ext) { #ext, loader_##ext, false, NULL },
+#define MAPPED_LOADER(ext) { #ext, loader_##ext, true, NULL },
+#define PARALLEL_LOADER(ext) { #ext, loader_##ext, false, register_##ext },
 #include "loader_def.h"
+#undef LOADER
 };
 
+static AssetJob* jobs;
+static int num_jobs, num_threads;
+static atomic_int next_job;
+static uint64_t load_time;
+
 static const char* get_extension(const char* name) {
     for (int i = strlen(name) - 1; i >= 0; i--) {
         if (name[i] == '/') return NULL;
@@ -47,36 +64,88 @@ static int compare_str(const void* a, const void* b) {
     return strcmp(*(char**)a, *(char**)b);
 }
 
-static uint8_t* read_asset_file(const char* name, size_t* length) {
+static uint8_t* map_asset_file(const char* name, size_t* length) {
     char filename[strlen(name) + 8];
     sprintf(filename, "assets/%s", name);
-    FILE* f = fopen(filename, "r" BINARY);
-    if (!f) return NULL;
-    fseek(f, 0, SEEK_END);
-    *length = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    uint8_t* bytes = malloc(*length);
-    fread(bytes, *length, 1, f);
-    fclose(f);
-    return bytes;
+    return map_file(filename, length);
 }
 
+static Loader* find_loader(const char* ext) {
+    if (!ext) return NULL;
+    for (int i = 0; i < sizeof(loaders) / sizeof(Loader); i++) {
+        if (strcmp(ext, loaders[i].ext) == 0) return &loaders[i];
+    }
+    return NULL;
+}
+
+static void run_job(AssetJob* job) {
+    uint64_t start = get_micros();
+    Asset* asset = job->asset;
+    size_t length = asset->length;
+    uint8_t* bytes = map_asset_file(asset->name, &length);
+    asset->data = job->loader->loader(asset->name, bytes ?: asset->raw, length);
+    if (!job->loader->mapped) unmap_file(bytes, length);
+    job->micros = get_micros() - start;
+}
+
+static void* asset_worker(void* arg) {
+    int i;
+    while ((i = atomic_fetch_add(&next_job, 1)) < num_jobs) {
+        if (jobs[i].loader && jobs[i].loader->finish) run_job(&jobs[i]);
+    }
+    return NULL;
+}
+
+// parallel loaders read and decode on a worker pool, the rest run afterwards in asset order
+// together with the registration of what the workers produced
 void load_assets() {
-    int num_assets = sizeof(assets) / sizeof(Asset);
-    int num_loaders = sizeof(loaders) / sizeof(Loader);
-    qsort(assets, num_assets, sizeof(Asset), compare_str);
-    for (int i = 0; i < sizeof(assets) / sizeof(Asset); i++) {
-        Asset* asset = &assets[i];
-        const char* ext = get_extension(asset->name);
-        size_t length = asset->length;
-        uint8_t* bytes = read_asset_file(asset->name, &length);
-        for (int j = 0; j < num_loaders; j++) {
-            Loader* loader = &loaders[j];
-            if (strcmp(ext, loader->ext) != 0) continue;
-            asset->data = loader->loader(asset->name, bytes ?: asset->raw, length);
-        }
-        free(bytes);
+    uint64_t start = get_micros();
+    num_jobs = sizeof(assets) / sizeof(Asset);
+    qsort(assets, num_jobs, sizeof(Asset), compare_str);
+    jobs = malloc(sizeof(AssetJob) * num_jobs);
+    for (int i = 0; i < num_jobs; i++) {
+        jobs[i] = (AssetJob){ &assets[i], find_loader(get_extension(assets[i].name)), 0 };
+    }
+    pthread_t threads[MAX_LOADER_THREADS];
+    int num_workers = 0;
+    atomic_store(&next_job, 0);
+    for (int i = 0; i < cpu_count() - 1 && i < MAX_LOADER_THREADS; i++) {
+        if (pthread_create(&threads[num_workers], NULL, asset_worker, NULL) != 0) break;
+        num_workers++;
+    }
+    asset_worker(NULL);
+    for (int i = 0; i < num_workers; i++) pthread_join(threads[i], NULL);
+    num_threads = num_workers + 1;
+    for (int i = 0; i < num_jobs; i++) {
+        if (!jobs[i].loader) continue;
+        if (jobs[i].loader->finish) jobs[i].loader->finish(jobs[i].asset->data);
+        else run_job(&jobs[i]);
+    }
+    load_time = get_micros() - start;
+}
+
+static int compare_job_time(const void* a, const void* b) {
+    uint64_t x = ((AssetJob*)a)->micros, y = ((AssetJob*)b)->micros;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+void report_asset_times() {
+    if (!jobs || num_jobs == 0) return;
+    int num_parallel = 0;
+    uint64_t parallel_time = 0;
+    for (int i = 0; i < num_jobs; i++) {
+        if (!jobs[i].loader || !jobs[i].loader->finish) continue;
+        num_parallel++;
+        parallel_time += jobs[i].micros;
     }
+    printf("Assets: %d of %d decoded on %d threads, %.2f ms of decoding in %.2f ms\n",
+        num_parallel, num_jobs, num_threads, parallel_time / 1000.f, load_time / 1000.f
+    );
+    qsort(jobs, num_jobs, sizeof(AssetJob), compare_job_time);
+    printf("Slowest assets:");
+    for (int i = 0; i < num_jobs && i < SLOWEST_ASSETS; i++) printf(" %s %.2f ms%s", jobs[i].asset->name, jobs[i].micros / 1000.f, i + 1 < SLOWEST_ASSETS && i + 1 < num_jobs ? "," : "\n");
+    free(jobs);
+    jobs = NULL;
 }
 
 void* _get_asset(const char* name) {
@@ -1,7 +1,18 @@
-LOADER(png)
+#ifndef MAPPED_LOADER
+#define MAPPED_LOADER(ext) LOADER(ext)
+#endif
+#ifndef PARALLEL_LOADER
+#define PARALLEL_LOADER(ext) LOADER(ext)
+#endif
+
+PARALLEL_LOADER(png)
 LOADER(glsl)
-LOADER(wav)
+MAPPED_LOADER(wav)
 LOADER(ogg)
 LOADER(txt)
 LOADER(c)
 LOADER(h)
+MAPPED_LOADER(lvl)
+
+#undef MAPPED_LOADER
+#undef PARALLEL_LOADER
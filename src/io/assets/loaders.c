@@ -1,8 +1,10 @@
 #include <stdint.h>
 #include <string.h>
+#include <stdio.h>
 #include <dlfcn.h>
 
 #include "main.h"
+#include "engine/engine.h"
 
 #ifdef _WIN32
 #include <stdlib.h>
@@ -27,7 +29,7 @@ void* loader_txt(const char* filename, uint8_t* bytes, int size) {
 
 void* loader_h(const char* filename, uint8_t* bytes, int size) {
     char* data = strndup((char*)bytes, size);
-    jitc_create_header(jitc_context, filename, data);
+    add_header(data, filename);
     return data;
 }
 
@@ -36,3 +38,9 @@ void* loader_c(const char* filename, uint8_t* bytes, int size) {
     add_compile_job(code, filename);
     return strndup((char*)bytes, size);
 }
+
+void* loader_lvl(const char* filename, uint8_t* bytes, int size) {
+    LevelAsset* level = engine_parse_level_asset(bytes, size);
+    if (!level) printf("Level '%s' is malformed\n", filename);
+    return level;
+}
@@ -4,6 +4,7 @@
 #include <stdint.h>
 
 #define LOADER(x) void* loader_##x(const char* filename, uint8_t* data, int len);
+#define PARALLEL_LOADER(x) LOADER(x) void register_##x(void* data);
 #include "loader_def.h"
 #undef LOADER
 
@@ -15,6 +15,8 @@ typedef union {
 typedef struct {
     Color* colors;
     int width, height;
+    int slot; // index into each window's uploaded textures, 0 until first use
+    unsigned generation; // bump after changing colors to upload them again
 } Texture;
 
 typedef struct Shader Shader;
@@ -44,17 +46,26 @@ void graphics_get_size(Window* window, int* width, int* height);
 void graphics_get_pos(Window* window, int* x, int* y);
 void graphics_screen_size(int* x, int* y);
 float graphics_get_dpi_scale(Window* window);
+bool graphics_set_vsync(Window* window, int interval); // 1 waits for vblank, 0 doesn't, -1 only while frames are on time
+float graphics_refresh_rate(Window* window); // 0 if unknown
 void graphics_set_active(Window* window);
 void graphics_start_frame(Window* window);
 void graphics_end_frame(Window* window);
 void graphics_post_process(Window* window, Shader* shader);
 void graphics_set_shader(Window* window, Shader* shader);
+void graphics_set_uniform(Shader* shader, const char* name, float x, float y, float z, float w);
 void graphics_rect(Window* window, float x, float y, float w, float h, Color color);
 void graphics_draw(Window* window, Texture* texture, float x, float y, float w, float h, float sx, float sy, float sw, float sh, Color color);
+void graphics_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text);
+void graphics_static_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text);
+void graphics_nine_slice(Window* window, Texture* texture, float sx, float sy, float sw, float sh, float inset, float x, float y, float w, float h, Color color);
 void graphics_blit(Window* window,  Buffer* buffer,  float x, float y, float w, float h, float sx, float sy, float sw, float sh, Color color);
 Buffer* graphics_new_buffer(Window* window, int width, int height);
+Buffer* graphics_frame_buffer(Window* window, int width, int height);
 void graphics_set_buffer(Window* window, Buffer* buffer);
 void graphics_destroy_buffer(Buffer* buffer);
+void graphics_buffer_stats(uint64_t* hits, uint64_t* misses);
+bool graphics_read_buffer(Window* window, Buffer* buffer, Color* out);
 bool graphics_should_close();
 
 #endif
@@ -0,0 +1,835 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_opengl.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "io/graphics.h"
+#include "io/platform.h"
+#include "stb_image.h"
+
+// opengl 3.3 core. every sprite, glyph and rect is one instance of a unit quad, instances are batched until
+// the texture or target changes and then drawn with one glDrawArraysInstanced. render targets are fbos that
+// store rows top down like uploaded textures, so both are sampled the same way.
+// selected with "graphics": "opengl" under backends in config.json, runs headless on mesa with SDL_VIDEO_DRIVER=offscreen.
+//
+// .glsl assets are fragment shaders. they get uv, tint and the image sampler like the default one below,
+// a vec4 size uniform with the target's size in pixels, and any vec4 uniforms set with graphics_set_uniform.
+// graphics_set_shader draws the following sprites with a shader, graphics_post_process queues a fullscreen
+// pass over what the current target holds so far, run before anything else is drawn to it.
+
+#define GLYPH_WIDTH 6
+#define GLYPH_HEIGHT 8
+#define GLYPH_COLUMNS 16
+#define POOL_FRAMES 60 // pooled buffers unused for this many frames are freed
+#define POOL_SIZE 16 // at most this many buffers stay pooled, the ones given back last are kept
+#define MAX_INSTANCES 4096
+#define INSTANCE_BUFFER_SIZE (MAX_INSTANCES * sizeof(Instance) * 16) // instances are streamed into it until it wraps
+#define MAX_UNIFORMS 8
+#define MAX_PASSES 8
+#define SHADER_CACHE_DIR "shader_cache" // linked program binaries, keyed by driver and source
+
+#define GL_FUNCTIONS(X) \
+    X(void,   ActiveTexture,           GLenum texture) \
+    X(void,   AttachShader,            GLuint program, GLuint shader) \
+    X(void,   BindBuffer,              GLenum target, GLuint buffer) \
+    X(void,   BindFramebuffer,         GLenum target, GLuint framebuffer) \
+    X(void,   BindTexture,             GLenum target, GLuint texture) \
+    X(void,   BindVertexArray,         GLuint array) \
+    X(void,   BlitFramebuffer,         GLint sx0, GLint sy0, GLint sx1, GLint sy1, GLint dx0, GLint dy0, GLint dx1, GLint dy1, GLbitfield mask, GLenum filter) \
+    X(void,   BlendFuncSeparate,       GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha) \
+    X(void,   BufferData,              GLenum target, GLsizeiptr size, const void* data, GLenum usage) \
+    X(void,   Clear,                   GLbitfield mask) \
+    X(void,   ClearColor,              GLfloat r, GLfloat g, GLfloat b, GLfloat a) \
+    X(void,   CompileShader,           GLuint shader) \
+    X(GLuint, CreateProgram,           void) \
+    X(GLuint, CreateShader,            GLenum type) \
+    X(void,   DeleteBuffers,           GLsizei n, const GLuint* buffers) \
+    X(void,   DeleteFramebuffers,      GLsizei n, const GLuint* framebuffers) \
+    X(void,   DeleteProgram,           GLuint program) \
+    X(void,   DeleteShader,            GLuint shader) \
+    X(void,   DeleteTextures,          GLsizei n, const GLuint* textures) \
+    X(void,   DeleteVertexArrays,      GLsizei n, const GLuint* arrays) \
+    X(void,   Disable,                 GLenum cap) \
+    X(void,   DrawArraysInstanced,     GLenum mode, GLint first, GLsizei count, GLsizei instances) \
+    X(void,   Enable,                  GLenum cap) \
+    X(void,   EnableVertexAttribArray, GLuint index) \
+    X(void,   FramebufferTexture2D,    GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) \
+    X(void,   GenBuffers,              GLsizei n, GLuint* buffers) \
+    X(void,   GenFramebuffers,         GLsizei n, GLuint* framebuffers) \
+    X(void,   GenTextures,             GLsizei n, GLuint* textures) \
+    X(void,   GenVertexArrays,         GLsizei n, GLuint* arrays) \
+    X(void,   GetProgramInfoLog,       GLuint program, GLsizei size, GLsizei* length, GLchar* log) \
+    X(void,   GetProgramiv,            GLuint program, GLenum name, GLint* value) \
+    X(void,   GetShaderInfoLog,        GLuint shader, GLsizei size, GLsizei* length, GLchar* log) \
+    X(void,   GetShaderiv,             GLuint shader, GLenum name, GLint* value) \
+    X(const GLubyte*, GetString,       GLenum name) \
+    X(GLint,  GetUniformLocation,      GLuint program, const GLchar* name) \
+    X(void,   LinkProgram,             GLuint program) \
+    X(void*,  MapBufferRange,          GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) \
+    X(void,   PixelStorei,             GLenum name, GLint value) \
+    X(void,   ReadPixels,              GLint x, GLint y, GLsizei w, GLsizei h, GLenum format, GLenum type, void* pixels) \
+    X(void,   ShaderSource,            GLuint shader, GLsizei count, const GLchar* const* source, const GLint* length) \
+    X(void,   TexImage2D,              GLenum target, GLint level, GLint format, GLsizei w, GLsizei h, GLint border, GLenum data_format, GLenum type, const void* pixels) \
+    X(void,   TexParameteri,           GLenum target, GLenum name, GLint value) \
+    X(void,   Uniform1i,               GLint location, GLint value) \
+    X(void,   Uniform4f,               GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) \
+    X(void,   Uniform4fv,              GLint location, GLsizei count, const GLfloat* value) \
+    X(GLboolean, UnmapBuffer,          GLenum target) \
+    X(void,   UseProgram,              GLuint program) \
+    X(void,   VertexAttribDivisor,     GLuint index, GLuint divisor) \
+    X(void,   VertexAttribPointer,     GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* offset) \
+    X(void,   Viewport,                GLint x, GLint y, GLsizei w, GLsizei h)
+
+// program binaries are core in 4.1, older drivers leave these NULL and always link from source
+#define GL_OPTIONAL_FUNCTIONS(X) \
+    X(void,   GetProgramBinary,        GLuint program, GLsizei size, GLsizei* length, GLenum* format, void* binary) \
+    X(void,   ProgramBinary,           GLuint program, GLenum format, const void* binary, GLsizei length) \
+    X(void,   ProgramParameteri,       GLuint program, GLenum name, GLint value)
+
+#define X(ret, name, ...) ret (APIENTRY *name)(__VA_ARGS__);
+static struct { GL_FUNCTIONS(X) GL_OPTIONAL_FUNCTIONS(X) } gl;
+#undef X
+
+static const char* vertex_source =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 corner;\n"
+    "layout(location = 1) in vec4 dst;\n"
+    "layout(location = 2) in vec4 src;\n"
+    "layout(location = 3) in vec4 color;\n"
+    "uniform vec4 projection;\n"
+    "out vec2 uv;\n"
+    "out vec4 tint;\n"
+    "void main() {\n"
+    "    gl_Position = vec4((dst.xy + corner * dst.zw) * projection.xy + projection.zw, 0.0, 1.0);\n"
+    "    uv = src.xy + corner * src.zw;\n"
+    "    tint = color;\n"
+    "}\n";
+
+static const char* fragment_source =
+    "#version 330 core\n"
+    "in vec2 uv;\n"
+    "in vec4 tint;\n"
+    "uniform sampler2D image;\n"
+    "out vec4 out_color;\n"
+    "void main() {\n"
+    "    out_color = texture(image, uv) * tint;\n"
+    "}\n";
+
+typedef struct {
+    float dst[4];
+    float src[4]; // in texture coordinates
+    uint8_t color[4];
+} Instance;
+
+typedef struct {
+    GLuint handle;
+    unsigned generation;
+} TextureSlot;
+
+struct Shader {
+    const char* name;
+    char* source;
+    Window* window; // whose context program belongs to
+    GLuint program;
+    int num_uniforms;
+    struct {
+        char* name;
+        float value[4];
+    } uniforms[MAX_UNIFORMS];
+};
+
+struct Buffer {
+    GLuint fbo, texture;
+    Window* window;
+    int width, height;
+    uint64_t released; // frame it went back to the pool
+    bool frame_scoped; // given back by graphics_end_frame, graphics_destroy_buffer leaves it alone
+    Buffer* next;
+};
+
+struct Window {
+    SDL_Window* wnd;
+    SDL_GLContext ctx;
+    float dpi_scale;
+    int width, height; // the size drawing coordinates are relative to on screen
+    GLuint vao, corners, instances, white;
+    size_t instance_offset;
+    Instance batch[MAX_INSTANCES];
+    int batch_size;
+    GLuint batch_texture;
+    Shader default_shader;
+    Shader* shader;
+    Shader* passes[MAX_PASSES];
+    int num_passes;
+    Buffer* target;
+    struct {
+        TextureSlot* slots;
+        int capacity;
+    } textures;
+    Buffer* free_buffers;
+    Buffer* frame_buffers;
+    uint64_t frame;
+};
+
+static Window* curr_window = NULL;
+static Window* context_window = NULL;
+static uint64_t buffer_hits, buffer_misses;
+static int num_texture_slots;
+static Texture** loaded_textures;
+static int loaded_textures_size, loaded_textures_capacity;
+static Shader** loaded_shaders;
+static int loaded_shaders_size, loaded_shaders_capacity;
+
+static void use_context(Window* window) {
+    if (context_window == window) return;
+    SDL_GL_MakeCurrent(window->wnd, window->ctx);
+    context_window = window;
+}
+
+static void register_texture(Texture* texture) {
+    texture->slot = ++num_texture_slots;
+    if (loaded_textures_size == loaded_textures_capacity) {
+        loaded_textures_capacity = loaded_textures_capacity == 0 ? 16 : loaded_textures_capacity * 2;
+        loaded_textures = realloc(loaded_textures, sizeof(Texture*) * loaded_textures_capacity);
+    }
+    loaded_textures[loaded_textures_size++] = texture;
+}
+
+static GLuint create_texture(int width, int height, const void* pixels) {
+    GLuint texture;
+    gl.GenTextures(1, &texture);
+    gl.BindTexture(GL_TEXTURE_2D, texture);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    gl.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    gl.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    gl.TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    return texture;
+}
+
+static GLuint get_texture(Window* window, Texture* texture) {
+    if (!texture) return 0;
+    if (!texture->slot) register_texture(texture);
+    if (texture->slot >= window->textures.capacity) {
+        int old_capacity = window->textures.capacity;
+        while (texture->slot >= window->textures.capacity) window->textures.capacity = window->textures.capacity == 0 ? 64 : window->textures.capacity * 2;
+        window->textures.slots = realloc(window->textures.slots, sizeof(TextureSlot) * window->textures.capacity);
+        memset(window->textures.slots + old_capacity, 0, sizeof(TextureSlot) * (window->textures.capacity - old_capacity));
+    }
+    TextureSlot* slot = &window->textures.slots[texture->slot];
+    if (slot->handle && slot->generation == texture->generation) return slot->handle;
+    if (slot->handle) gl.DeleteTextures(1, &slot->handle);
+    slot->handle = create_texture(texture->width, texture->height, texture->colors);
+    slot->generation = texture->generation;
+    return slot->handle;
+}
+
+static GLuint compile_shader(GLenum type, const char* source) {
+    GLuint shader = gl.CreateShader(type);
+    gl.ShaderSource(shader, 1, &source, NULL);
+    gl.CompileShader(shader);
+    GLint success;
+    gl.GetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char log[1024];
+        gl.GetShaderInfoLog(shader, sizeof(log), NULL, log);
+        fprintf(stderr, "Failed to compile shader: %s\n", log);
+    }
+    return shader;
+}
+
+static GLuint link_program(const char* name, const char* vertex, const char* fragment) {
+    GLuint program = gl.CreateProgram();
+    GLuint vs = compile_shader(GL_VERTEX_SHADER, vertex), fs = compile_shader(GL_FRAGMENT_SHADER, fragment);
+    gl.AttachShader(program, vs);
+    gl.AttachShader(program, fs);
+    if (gl.ProgramParameteri) gl.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    gl.LinkProgram(program);
+    gl.DeleteShader(vs);
+    gl.DeleteShader(fs);
+    GLint success;
+    gl.GetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char log[1024];
+        gl.GetProgramInfoLog(program, sizeof(log), NULL, log);
+        fprintf(stderr, "Failed to link shader '%s': %s\n", name, log);
+        gl.DeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+static void hash_string(uint64_t* hash, const char* str) {
+    while (str && *str) *hash = (*hash ^ (uint8_t)*str++) * 0x100000001b3;
+}
+
+// binaries only load on the driver that wrote them, so the driver strings are part of the key
+static void shader_cache_path(const char* fragment, char* path, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325;
+    hash_string(&hash, (const char*)gl.GetString(GL_VENDOR));
+    hash_string(&hash, (const char*)gl.GetString(GL_RENDERER));
+    hash_string(&hash, (const char*)gl.GetString(GL_VERSION));
+    hash_string(&hash, vertex_source);
+    hash_string(&hash, fragment);
+    snprintf(path, size, SHADER_CACHE_DIR "/%016llx.bin", (unsigned long long)hash);
+}
+
+static GLuint load_program_binary(const char* path) {
+    size_t length;
+    uint8_t* data = map_file(path, &length);
+    if (!data) return 0;
+    GLuint program = 0;
+    if (length > sizeof(GLenum)) {
+        GLenum format;
+        memcpy(&format, data, sizeof(format));
+        program = gl.CreateProgram();
+        gl.ProgramBinary(program, format, data + sizeof(format), length - sizeof(format));
+        GLint success;
+        gl.GetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            gl.DeleteProgram(program);
+            program = 0;
+        }
+    }
+    unmap_file(data, length);
+    return program;
+}
+
+static void save_program_binary(GLuint program, const char* path) {
+    GLint length;
+    gl.GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || !make_dir(SHADER_CACHE_DIR)) return;
+    uint8_t* data = malloc(length);
+    GLenum format;
+    gl.GetProgramBinary(program, length, &length, &format, data);
+    FILE* f = fopen(path, "wb");
+    if (f) {
+        fwrite(&format, sizeof(format), 1, f);
+        fwrite(data, length, 1, f);
+        fclose(f);
+    }
+    free(data);
+}
+
+static GLuint build_program(const char* name, const char* fragment) {
+    char path[64];
+    bool binaries = gl.GetProgramBinary && gl.ProgramBinary;
+    if (binaries) {
+        shader_cache_path(fragment, path, sizeof(path));
+        GLuint program = load_program_binary(path);
+        if (program) return program;
+    }
+    GLuint program = link_program(name, vertex_source, fragment);
+    if (program && binaries) save_program_binary(program, path);
+    return program;
+}
+
+// a shader that fails to build draws like the default one instead
+static GLuint get_program(Window* window, Shader* shader) {
+    if (!shader) shader = &window->default_shader;
+    if (shader->window != window) {
+        shader->program = build_program(shader->name, shader->source);
+        shader->window = window;
+    }
+    return shader->program ? shader->program : window->default_shader.program;
+}
+
+// screen coordinates grow downwards, buffers are flipped so their first row is the top one
+static void bind_target(Window* window) {
+    Buffer* target = window->target;
+    gl.BindFramebuffer(GL_FRAMEBUFFER, target ? target->fbo : 0);
+    if (target) gl.Viewport(0, 0, target->width, target->height);
+    else {
+        int width, height;
+        SDL_GetWindowSizeInPixels(window->wnd, &width, &height);
+        gl.Viewport(0, 0, width, height);
+    }
+}
+
+static void use_shader(Window* window, Shader* shader) {
+    GLuint program = get_program(window, shader);
+    Buffer* target = window->target;
+    gl.UseProgram(program);
+    gl.Uniform1i(gl.GetUniformLocation(program, "image"), 0);
+    if (target) gl.Uniform4f(gl.GetUniformLocation(program, "projection"), 2.f / target->width, 2.f / target->height, -1, -1);
+    else gl.Uniform4f(gl.GetUniformLocation(program, "projection"), 2.f / window->width, -2.f / window->height, -1, 1);
+    int width = target ? target->width : 0, height = target ? target->height : 0;
+    if (!target) SDL_GetWindowSizeInPixels(window->wnd, &width, &height);
+    gl.Uniform4f(gl.GetUniformLocation(program, "size"), width, height, 0, 0);
+    for (int i = 0; shader && i < shader->num_uniforms; i++) {
+        gl.Uniform4fv(gl.GetUniformLocation(program, shader->uniforms[i].name), 1, shader->uniforms[i].value);
+    }
+}
+
+static void flush(Window* window) {
+    if (window->batch_size == 0) return;
+    size_t size = sizeof(Instance) * window->batch_size;
+    gl.BindBuffer(GL_ARRAY_BUFFER, window->instances);
+    if (window->instance_offset + size > INSTANCE_BUFFER_SIZE) {
+        gl.BufferData(GL_ARRAY_BUFFER, INSTANCE_BUFFER_SIZE, NULL, GL_STREAM_DRAW);
+        window->instance_offset = 0;
+    }
+    void* mapped = gl.MapBufferRange(GL_ARRAY_BUFFER, window->instance_offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    memcpy(mapped, window->batch, size);
+    gl.UnmapBuffer(GL_ARRAY_BUFFER);
+    size_t offset = window->instance_offset;
+    gl.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, dst)));
+    gl.VertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, src)));
+    gl.VertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)(offset + offsetof(Instance, color)));
+    use_shader(window, window->shader);
+    gl.BindTexture(GL_TEXTURE_2D, window->batch_texture);
+    gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, window->batch_size);
+    window->instance_offset += size;
+    window->batch_size = 0;
+}
+
+// copies the target into a pooled buffer, then every pass but the last draws into the other of two buffers
+// and the last one back into the target
+static void run_passes(Window* window) {
+    if (window->num_passes == 0) return;
+    flush(window);
+    Buffer* target = window->target;
+    Shader* shader = window->shader;
+    int width, height;
+    if (target) width = target->width, height = target->height;
+    else SDL_GetWindowSizeInPixels(window->wnd, &width, &height);
+    Buffer* ping = graphics_new_buffer(window, width, height);
+    Buffer* pong = window->num_passes > 1 ? graphics_new_buffer(window, width, height) : NULL;
+    gl.BindFramebuffer(GL_READ_FRAMEBUFFER, target ? target->fbo : 0);
+    gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, ping->fbo);
+    if (target) gl.BlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    else gl.BlitFramebuffer(0, 0, width, height, 0, height, width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    gl.Disable(GL_BLEND);
+    Buffer* src = ping;
+    for (int i = 0; i < window->num_passes; i++) {
+        Buffer* dst = i == window->num_passes - 1 ? target : src == ping ? pong : ping;
+        window->target = dst;
+        window->shader = window->passes[i];
+        window->batch_texture = src->texture;
+        window->batch[window->batch_size++] = (Instance){
+            .dst = { 0, 0, dst ? dst->width : window->width, dst ? dst->height : window->height },
+            .src = { 0, 0, 1, 1 },
+            .color = { 255, 255, 255, 255 },
+        };
+        bind_target(window);
+        flush(window);
+        src = dst;
+    }
+    gl.Enable(GL_BLEND);
+    window->target = target;
+    window->shader = shader;
+    window->num_passes = 0;
+    graphics_destroy_buffer(ping);
+    if (pong) graphics_destroy_buffer(pong);
+}
+
+static void push_instance(Window* window, GLuint texture, int width, int height, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!texture) return;
+    run_passes(window);
+    if (window->batch_texture != texture || window->batch_size == MAX_INSTANCES) {
+        flush(window);
+        window->batch_texture = texture;
+    }
+    window->batch[window->batch_size++] = (Instance){
+        .dst = { dx, dy, dw, dh },
+        .src = { sx / width, sy / height, sw / width, sh / height },
+        .color = { color.r, color.g, color.b, color.a },
+    };
+}
+
+static void init_video() {
+    static bool inited = false;
+    if (inited) return;
+    inited = true;
+    SDL_Init(SDL_INIT_VIDEO);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+}
+
+static bool load_functions() {
+    static bool loaded = false;
+    if (loaded) return true;
+#define X(ret, name, ...) if (!(gl.name = (void*)SDL_GL_GetProcAddress("gl" #name))) { fprintf(stderr, "Missing gl" #name "\n"); return false; }
+    GL_FUNCTIONS(X)
+#undef X
+#define X(ret, name, ...) gl.name = (void*)SDL_GL_GetProcAddress("gl" #name);
+    GL_OPTIONAL_FUNCTIONS(X)
+#undef X
+    return loaded = true;
+}
+
+static void free_buffers(Buffer* buffer) {
+    while (buffer) {
+        Buffer* next = buffer->next;
+        gl.DeleteFramebuffers(1, &buffer->fbo);
+        gl.DeleteTextures(1, &buffer->texture);
+        free(buffer);
+        buffer = next;
+    }
+}
+
+static void release_buffer(Window* window, Buffer* buffer) {
+    buffer->frame_scoped = false;
+    buffer->released = window->frame;
+    buffer->next = window->free_buffers;
+    window->free_buffers = buffer;
+}
+
+// frees pooled buffers that went unused for too long or don't fit, buffers are pushed so the list is newest first
+static void trim_pool(Window* window) {
+    int kept = 0;
+    for (Buffer** curr = &window->free_buffers; *curr;) {
+        Buffer* buffer = *curr;
+        if (kept < POOL_SIZE && window->frame - buffer->released <= POOL_FRAMES) {
+            kept++;
+            curr = &buffer->next;
+            continue;
+        }
+        *curr = buffer->next;
+        buffer->next = NULL;
+        free_buffers(buffer);
+    }
+}
+
+Window* graphics_open(const char* title, int width, int height) {
+    init_video();
+
+    Window* w = calloc(1, sizeof(Window));
+    w->wnd = SDL_CreateWindow(title, width, height, SDL_WINDOW_OPENGL);
+    SDL_HideCursor();
+    w->ctx = SDL_GL_CreateContext(w->wnd);
+    if (!w->ctx || !load_functions()) {
+        fprintf(stderr, "Failed to create an OpenGL 3.3 context: %s\n", SDL_GetError());
+        exit(1);
+    }
+    context_window = w;
+    SDL_GL_SetSwapInterval(1);
+    int window_width;
+    SDL_GetWindowSize(w->wnd, &window_width, NULL);
+    w->dpi_scale = window_width / (float)width;
+    w->width = width;
+    w->height = height;
+
+    w->default_shader = (Shader){ .name = "default", .source = (char*)fragment_source };
+    if (!get_program(w, NULL)) exit(1);
+
+    static const float corners[] = { 0, 0, 1, 0, 0, 1, 1, 1 };
+    gl.GenVertexArrays(1, &w->vao);
+    gl.BindVertexArray(w->vao);
+    gl.GenBuffers(1, &w->corners);
+    gl.BindBuffer(GL_ARRAY_BUFFER, w->corners);
+    gl.BufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, NULL);
+    gl.EnableVertexAttribArray(0);
+    gl.GenBuffers(1, &w->instances);
+    gl.BindBuffer(GL_ARRAY_BUFFER, w->instances);
+    gl.BufferData(GL_ARRAY_BUFFER, INSTANCE_BUFFER_SIZE, NULL, GL_STREAM_DRAW);
+    for (int i = 1; i <= 3; i++) {
+        gl.EnableVertexAttribArray(i);
+        gl.VertexAttribDivisor(i, 1);
+    }
+
+    gl.Enable(GL_BLEND);
+    gl.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    gl.ActiveTexture(GL_TEXTURE0);
+    w->white = create_texture(1, 1, (uint8_t[]){ 255, 255, 255, 255 });
+    bind_target(w);
+    curr_window = w;
+    return w;
+}
+
+void graphics_close(Window* w) {
+    if (!w) w = curr_window;
+    use_context(w);
+    for (int i = 0; i < w->textures.capacity; i++) {
+        if (w->textures.slots[i].handle) gl.DeleteTextures(1, &w->textures.slots[i].handle);
+    }
+    free(w->textures.slots);
+    free_buffers(w->free_buffers);
+    free_buffers(w->frame_buffers);
+    gl.DeleteTextures(1, &w->white);
+    gl.DeleteBuffers(1, &w->corners);
+    gl.DeleteBuffers(1, &w->instances);
+    gl.DeleteVertexArrays(1, &w->vao);
+    for (int i = 0; i < loaded_shaders_size; i++) {
+        if (loaded_shaders[i]->window != w) continue;
+        if (loaded_shaders[i]->program) gl.DeleteProgram(loaded_shaders[i]->program);
+        loaded_shaders[i]->window = NULL;
+    }
+    gl.DeleteProgram(w->default_shader.program);
+    SDL_GL_DestroyContext(w->ctx);
+    SDL_DestroyWindow(w->wnd);
+    context_window = NULL;
+}
+
+void graphics_focus(Window* w) {
+    if (!w) w = curr_window;
+    SDL_RaiseWindow(w->wnd);
+}
+
+void graphics_get_size(Window* w, int* width, int* height) {
+    if (!w) w = curr_window;
+    SDL_GetWindowSize(w->wnd, width, height);
+}
+
+void graphics_get_pos(Window* w, int* x, int* y) {
+    if (!w) w = curr_window;
+    SDL_GetWindowPosition(w->wnd, x, y);
+}
+
+void graphics_screen_size(int* x, int* y) {
+    init_video();
+
+    const SDL_DisplayMode* dm = SDL_GetCurrentDisplayMode(SDL_GetDisplays(NULL)[0]);
+    *x = dm->w;
+    *y = dm->h;
+}
+
+float graphics_get_dpi_scale(Window* w) {
+    if (!w) w = curr_window;
+    return w->dpi_scale;
+}
+
+bool graphics_set_vsync(Window* w, int interval) {
+    if (!w) w = curr_window;
+    use_context(w);
+    return SDL_GL_SetSwapInterval(interval);
+}
+
+float graphics_refresh_rate(Window* w) {
+    if (!w) w = curr_window;
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(w->wnd));
+    return mode ? mode->refresh_rate : 0;
+}
+
+// the window the game draws to gets every loaded texture uploaded and shader linked up front instead of on first use
+void graphics_set_active(Window* w) {
+    curr_window = w;
+    use_context(w);
+    for (int i = 0; i < loaded_textures_size; i++) get_texture(w, loaded_textures[i]);
+    for (int i = 0; i < loaded_shaders_size; i++) get_program(w, loaded_shaders[i]);
+}
+
+void graphics_start_frame(Window* w) {
+    if (!w) w = curr_window;
+    use_context(w);
+    run_passes(w);
+    flush(w);
+    w->target = NULL;
+    w->shader = NULL;
+    bind_target(w);
+    gl.ClearColor(0, 0, 0, 1);
+    gl.Clear(GL_COLOR_BUFFER_BIT);
+}
+
+void graphics_end_frame(Window* w) {
+    if (!w) w = curr_window;
+    use_context(w);
+    run_passes(w);
+    flush(w);
+    SDL_GL_SwapWindow(w->wnd);
+    while (w->frame_buffers) {
+        Buffer* next = w->frame_buffers->next;
+        release_buffer(w, w->frame_buffers);
+        w->frame_buffers = next;
+    }
+    w->frame++;
+    trim_pool(w);
+}
+
+void graphics_rect(Window* window, float x, float y, float w, float h, Color color) {
+    if (!window) window = curr_window;
+    use_context(window);
+    push_instance(window, window->white, 1, 1, x, y, w, h, 0, 0, 1, 1, color);
+}
+
+void graphics_draw(Window* window, Texture* texture, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    if (!texture) return;
+    use_context(window);
+    push_instance(window, get_texture(window, texture), texture->width, texture->height, dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+void graphics_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    if (!window) window = curr_window;
+    for (int i = 0; text[i]; i++) {
+        unsigned char c = text[i];
+        if (c < ' ') continue;
+        graphics_draw(window, font,
+            x + i * GLYPH_WIDTH * scale, y, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale,
+            (c % GLYPH_COLUMNS) * GLYPH_WIDTH, (c - ' ') / GLYPH_COLUMNS * GLYPH_HEIGHT, GLYPH_WIDTH, GLYPH_HEIGHT,
+            color
+        );
+    }
+}
+
+// glyphs join the current instance batch, a cached buffer would only split it
+void graphics_static_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    graphics_text(window, font, x, y, scale, color, text);
+}
+
+void graphics_nine_slice(Window* window, Texture* texture, float sx, float sy, float sw, float sh, float inset, float dx, float dy, float dw, float dh, Color color) {
+    float src_x[] = { sx, sx + inset, sx + sw - inset }, src_w[] = { inset, sw - inset * 2, inset };
+    float src_y[] = { sy, sy + inset, sy + sh - inset }, src_h[] = { inset, sh - inset * 2, inset };
+    float dst_x[] = { dx, dx + inset, dx + dw - inset }, dst_w[] = { inset, dw - inset * 2, inset };
+    float dst_y[] = { dy, dy + inset, dy + dh - inset }, dst_h[] = { inset, dh - inset * 2, inset };
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 3; x++) {
+            graphics_draw(window, texture, dst_x[x], dst_y[y], dst_w[x], dst_h[y], src_x[x], src_y[y], src_w[x], src_h[y], color);
+        }
+    }
+}
+
+void graphics_blit(Window* window, Buffer* buffer, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    use_context(window);
+    push_instance(window, buffer->texture, buffer->width, buffer->height, dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+// every buffer handed out starts transparent, pooled ones still hold what their last user drew
+static void clear_buffer(Window* window, Buffer* buffer) {
+    use_context(window);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, buffer->fbo);
+    gl.ClearColor(0, 0, 0, 0);
+    gl.Clear(GL_COLOR_BUFFER_BIT);
+    bind_target(window);
+}
+
+Buffer* graphics_new_buffer(Window* window, int width, int height) {
+    if (!window) window = curr_window;
+    for (Buffer** curr = &window->free_buffers; *curr; curr = &(*curr)->next) {
+        if ((*curr)->width != width || (*curr)->height != height) continue;
+        Buffer* buffer = *curr;
+        *curr = buffer->next;
+        buffer_hits++;
+        clear_buffer(window, buffer);
+        return buffer;
+    }
+    buffer_misses++;
+    use_context(window);
+    Buffer* buffer = malloc(sizeof(Buffer));
+    buffer->texture = create_texture(width, height, NULL);
+    buffer->window = window;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->frame_scoped = false;
+    gl.GenFramebuffers(1, &buffer->fbo);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, buffer->fbo);
+    gl.FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer->texture, 0);
+    clear_buffer(window, buffer);
+    return buffer;
+}
+
+Buffer* graphics_frame_buffer(Window* window, int width, int height) {
+    if (!window) window = curr_window;
+    Buffer* buffer = graphics_new_buffer(window, width, height);
+    buffer->frame_scoped = true;
+    buffer->next = window->frame_buffers;
+    window->frame_buffers = buffer;
+    return buffer;
+}
+
+void graphics_set_buffer(Window* window, Buffer* buffer) {
+    if (!window) window = curr_window;
+    use_context(window);
+    run_passes(window);
+    flush(window);
+    window->target = buffer;
+    bind_target(window);
+}
+
+void graphics_destroy_buffer(Buffer* buffer) {
+    if (buffer->frame_scoped) return; // pooling it here too would link it into the free list twice
+    release_buffer(buffer->window, buffer);
+}
+
+void graphics_buffer_stats(uint64_t* hits, uint64_t* misses) {
+    *hits = buffer_hits;
+    *misses = buffer_misses;
+}
+
+bool graphics_read_buffer(Window* window, Buffer* buffer, Color* out) {
+    if (!window) window = curr_window;
+    use_context(window);
+    run_passes(window);
+    flush(window);
+    gl.BindFramebuffer(GL_FRAMEBUFFER, buffer->fbo);
+    gl.PixelStorei(GL_PACK_ALIGNMENT, 4);
+    gl.ReadPixels(0, 0, buffer->width, buffer->height, GL_RGBA, GL_UNSIGNED_BYTE, out);
+    bind_target(window);
+    return true;
+}
+
+void* loader_png(const char* filename, uint8_t* data, int len) {
+    int c;
+    Texture* texture = malloc(sizeof(Texture));
+    texture->colors = (Color*)stbi_load_from_memory(data, len, &texture->width, &texture->height, &c, 4);
+    texture->slot = 0;
+    texture->generation = 0;
+    return texture;
+}
+
+void register_png(void* data) {
+    if (data) register_texture(data);
+}
+
+bool graphics_should_close() {
+    SDL_PumpEvents();
+    return SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_EVENT_QUIT, SDL_EVENT_QUIT) > 0;
+}
+
+void graphics_post_process(Window* window, Shader* shader) {
+    if (!window) window = curr_window;
+    if (!shader || window->num_passes == MAX_PASSES) return;
+    window->passes[window->num_passes++] = shader;
+}
+
+void graphics_set_shader(Window* window, Shader* shader) {
+    if (!window) window = curr_window;
+    if (window->shader == shader) return;
+    use_context(window);
+    run_passes(window);
+    flush(window);
+    window->shader = shader;
+}
+
+void graphics_set_uniform(Shader* shader, const char* name, float x, float y, float z, float w) {
+    if (!shader) return;
+    int i = 0;
+    while (i < shader->num_uniforms && strcmp(shader->uniforms[i].name, name) != 0) i++;
+    if (i == MAX_UNIFORMS) return;
+    if (i == shader->num_uniforms) shader->uniforms[shader->num_uniforms++].name = strdup(name);
+    // whatever was queued with the shader so far still has to see the old value
+    if (curr_window) {
+        for (int j = 0; j < curr_window->num_passes; j++) {
+            if (curr_window->passes[j] == shader) run_passes(curr_window);
+        }
+        if (curr_window->shader == shader) flush(curr_window);
+    }
+    float* value = shader->uniforms[i].value;
+    value[0] = x, value[1] = y, value[2] = z, value[3] = w;
+}
+
+void* loader_glsl(const char* filename, uint8_t* data, int len) {
+    Shader* shader = calloc(1, sizeof(Shader));
+    shader->name = filename;
+    shader->source = malloc(len + 1);
+    memcpy(shader->source, data, len);
+    shader->source[len] = 0;
+    if (loaded_shaders_size == loaded_shaders_capacity) {
+        loaded_shaders_capacity = loaded_shaders_capacity == 0 ? 16 : loaded_shaders_capacity * 2;
+        loaded_shaders = realloc(loaded_shaders, sizeof(Shader*) * loaded_shaders_capacity);
+    }
+    loaded_shaders[loaded_shaders_size++] = shader;
+    // assets loaded before any window is open are linked by graphics_set_active instead
+    if (curr_window) {
+        use_context(curr_window);
+        get_program(curr_window, shader);
+    }
+    return shader;
+}
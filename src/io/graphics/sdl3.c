@@ -1,48 +1,129 @@
 #include <SDL3/SDL.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "io/graphics.h"
 #include "stb_image.h"
 
+#define GLYPH_WIDTH 6
+#define GLYPH_HEIGHT 8
+#define GLYPH_COLUMNS 16
+#define POOL_FRAMES 60 // pooled buffers unused for this many frames are freed
+#define POOL_SIZE 16 // at most this many buffers stay pooled, the ones given back last are kept
+#define TEXT_CACHE_FRAMES 120 // cached text unused for this many frames gives its buffer back to the pool
+
 typedef struct {
-    Texture* texture;
     SDL_Texture* handle;
-} TextureEntry;
+    unsigned generation;
+} TextureSlot;
+
+typedef struct TextCacheEntry TextCacheEntry;
+
+struct Buffer {
+    SDL_Texture* texture;
+    Window* window;
+    int width, height;
+    uint64_t released; // frame it went back to the pool
+    bool frame_scoped; // given back by graphics_end_frame, graphics_destroy_buffer leaves it alone
+    Buffer* next;
+};
 
 struct Window {
     SDL_Window* wnd;
     SDL_Renderer* rnd;
     float dpi_scale;
     struct {
-        TextureEntry* entries;
-        int size, capacity;
-    } texture_map;
+        TextureSlot* slots;
+        int capacity;
+    } textures;
+    Buffer* free_buffers; // render targets given back with graphics_destroy_buffer, reused by graphics_new_buffer
+    Buffer* frame_buffers; // released when the frame ends
+    TextCacheEntry* text_cache;
+    struct {
+        SDL_Vertex* vertices;
+        int* indices;
+        int capacity; // in quads, grows to the longest text drawn
+    } quads;
+    uint64_t frame;
+};
+
+struct TextCacheEntry {
+    char* text;
+    Texture* font;
+    Color color;
+    int scale;
+    Buffer* buffer;
+    uint64_t last_used;
+    TextCacheEntry* next;
 };
 
 static Window* curr_window = NULL;
+static uint64_t buffer_hits, buffer_misses;
+
+static int num_texture_slots;
+static Texture** loaded_textures;
+static int loaded_textures_size, loaded_textures_capacity;
 
-static int compare_entry(const void* _a, const void* _b) {
-    TextureEntry* a = *(TextureEntry**)_a;
-    TextureEntry* b = *(TextureEntry**)_b;
-    return (uintptr_t)b->texture - (uintptr_t)a->texture;
+static void register_texture(Texture* texture) {
+    texture->slot = ++num_texture_slots;
+    if (loaded_textures_size == loaded_textures_capacity) {
+        loaded_textures_capacity = loaded_textures_capacity == 0 ? 16 : loaded_textures_capacity * 2;
+        loaded_textures = realloc(loaded_textures, sizeof(Texture*) * loaded_textures_capacity);
+    }
+    loaded_textures[loaded_textures_size++] = texture;
 }
 
 static SDL_Texture* get_texture(Window* window, Texture* texture, SDL_Renderer* renderer) {
     if (!texture) return NULL;
-    TextureEntry* entry = bsearch(&texture, window->texture_map.entries, window->texture_map.size, sizeof(TextureEntry), compare_entry);
-    if (entry) return entry->handle;
-    if (window->texture_map.size == window->texture_map.capacity) {
-        window->texture_map.capacity *= 2;
-        window->texture_map.entries = realloc(window->texture_map.entries, sizeof(TextureEntry) * window->texture_map.capacity);
+    if (!texture->slot) register_texture(texture);
+    if (texture->slot >= window->textures.capacity) {
+        int old_capacity = window->textures.capacity;
+        while (texture->slot >= window->textures.capacity) window->textures.capacity = window->textures.capacity == 0 ? 64 : window->textures.capacity * 2;
+        window->textures.slots = realloc(window->textures.slots, sizeof(TextureSlot) * window->textures.capacity);
+        memset(window->textures.slots + old_capacity, 0, sizeof(TextureSlot) * (window->textures.capacity - old_capacity));
     }
+    TextureSlot* slot = &window->textures.slots[texture->slot];
+    if (slot->handle && slot->generation == texture->generation) return slot->handle;
+    if (slot->handle) SDL_DestroyTexture(slot->handle);
     SDL_Surface* surface = SDL_CreateSurfaceFrom(texture->width, texture->height, SDL_PIXELFORMAT_ABGR8888, texture->colors, 4 * texture->width);
-    SDL_Texture* handle = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_SetTextureScaleMode(handle, SDL_SCALEMODE_NEAREST);
+    slot->handle = SDL_CreateTextureFromSurface(renderer, surface);
+    slot->generation = texture->generation;
+    SDL_SetTextureScaleMode(slot->handle, SDL_SCALEMODE_NEAREST);
     SDL_DestroySurface(surface);
-    window->texture_map.entries[window->texture_map.size++] = (TextureEntry){ .texture = texture, .handle = handle };
-    qsort(window->texture_map.entries, window->texture_map.size, sizeof(TextureEntry), compare_entry);
-    return handle;
+    return slot->handle;
+}
+
+static void free_buffers(Buffer* buffer) {
+    while (buffer) {
+        Buffer* next = buffer->next;
+        SDL_DestroyTexture(buffer->texture);
+        free(buffer);
+        buffer = next;
+    }
+}
+
+static void release_buffer(Window* window, Buffer* buffer) {
+    buffer->frame_scoped = false;
+    buffer->released = window->frame;
+    buffer->next = window->free_buffers;
+    window->free_buffers = buffer;
+}
+
+// frees pooled buffers that went unused for too long or don't fit, buffers are pushed so the list is newest first
+static void trim_pool(Window* window) {
+    int kept = 0;
+    for (Buffer** curr = &window->free_buffers; *curr;) {
+        Buffer* buffer = *curr;
+        if (kept < POOL_SIZE && window->frame - buffer->released <= POOL_FRAMES) {
+            kept++;
+            curr = &buffer->next;
+            continue;
+        }
+        *curr = buffer->next;
+        buffer->next = NULL;
+        free_buffers(buffer);
+    }
 }
 
 static void init_video() {
@@ -73,15 +154,37 @@ Window* graphics_open(const char* title, int width, int height) {
     w->wnd = SDL_CreateWindow(title, width, height, 0);
     SDL_HideCursor();
     graphics_get_renderer(w, width);
-    w->texture_map.capacity = 4;
-    w->texture_map.size = 0;
-    w->texture_map.entries = malloc(sizeof(TextureEntry) * w->texture_map.capacity);
+    w->textures.slots = NULL;
+    w->textures.capacity = 0;
+    w->free_buffers = NULL;
+    w->frame_buffers = NULL;
+    w->text_cache = NULL;
+    w->quads.vertices = NULL;
+    w->quads.indices = NULL;
+    w->quads.capacity = 0;
+    w->frame = 0;
     curr_window = w;
     return w;
 }
 
 void graphics_close(Window* w) {
     if (!w) w = curr_window;
+    for (int i = 0; i < w->textures.capacity; i++) {
+        if (w->textures.slots[i].handle) SDL_DestroyTexture(w->textures.slots[i].handle);
+    }
+    free(w->textures.slots);
+    while (w->text_cache) {
+        TextCacheEntry* next = w->text_cache->next;
+        w->text_cache->buffer->next = w->free_buffers;
+        w->free_buffers = w->text_cache->buffer;
+        free(w->text_cache->text);
+        free(w->text_cache);
+        w->text_cache = next;
+    }
+    free_buffers(w->free_buffers);
+    free_buffers(w->frame_buffers);
+    free(w->quads.vertices);
+    free(w->quads.indices);
     graphics_destroy_renderer(w->rnd);
     SDL_DestroyWindow(w->wnd);
 }
@@ -114,8 +217,21 @@ float graphics_get_dpi_scale(Window* w) {
     return w->dpi_scale;
 }
 
+bool graphics_set_vsync(Window* w, int interval) {
+    if (!w) w = curr_window;
+    return SDL_SetRenderVSync(w->rnd, interval);
+}
+
+float graphics_refresh_rate(Window* w) {
+    if (!w) w = curr_window;
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(w->wnd));
+    return mode ? mode->refresh_rate : 0;
+}
+
+// the window the game draws to gets every loaded texture uploaded up front instead of on first use
 void graphics_set_active(Window* w) {
     curr_window = w;
+    for (int i = 0; i < loaded_textures_size; i++) get_texture(w, loaded_textures[i], w->rnd);
 }
 
 void graphics_start_frame(Window* w) {
@@ -127,6 +243,24 @@ void graphics_start_frame(Window* w) {
 void graphics_end_frame(Window* w) {
     if (!w) w = curr_window;
     SDL_RenderPresent(w->rnd);
+    while (w->frame_buffers) {
+        Buffer* next = w->frame_buffers->next;
+        release_buffer(w, w->frame_buffers);
+        w->frame_buffers = next;
+    }
+    w->frame++;
+    for (TextCacheEntry** curr = &w->text_cache; *curr;) {
+        TextCacheEntry* entry = *curr;
+        if (w->frame - entry->last_used <= TEXT_CACHE_FRAMES) {
+            curr = &entry->next;
+            continue;
+        }
+        *curr = entry->next;
+        graphics_destroy_buffer(entry->buffer);
+        free(entry->text);
+        free(entry);
+    }
+    trim_pool(w);
 }
 
 void graphics_rect(Window* window, float x, float y, float w, float h, Color color) {
@@ -135,15 +269,7 @@ void graphics_rect(Window* window, float x, float y, float w, float h, Color col
     SDL_RenderFillRect(window->rnd, (SDL_FRect[]){{ .x = x, .y = y, .w = w, .h = h }});
 }
 
-void graphics_draw(Window* window, Texture* texture, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
-    if (!window) window = curr_window;
-    void* tex = get_texture(window, texture, window->rnd);
-    graphics_blit(window, tex, dx, dy, dw, dh, sx, sy, sw, sh, color);
-}
-
-void graphics_blit(Window* window, Buffer* buffer, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
-    if (!window) window = curr_window;
-    SDL_Texture* texture = (void*)buffer;
+static void blit_texture(Window* window, SDL_Texture* texture, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
     SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
     SDL_SetTextureAlphaMod(texture, color.a);
     SDL_RenderTexture(window->rnd, texture,
@@ -152,29 +278,198 @@ void graphics_blit(Window* window, Buffer* buffer, float dx, float dy, float dw,
     );
 }
 
+void graphics_draw(Window* window, Texture* texture, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    blit_texture(window, get_texture(window, texture, window->rnd), dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+void graphics_blit(Window* window, Buffer* buffer, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    blit_texture(window, buffer->texture, dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+// every buffer handed out starts transparent, pooled ones still hold what their last user drew
+static void clear_buffer(Window* window, Buffer* buffer) {
+    SDL_Texture* target = SDL_GetRenderTarget(window->rnd);
+    SDL_SetRenderTarget(window->rnd, buffer->texture);
+    SDL_SetRenderDrawColor(window->rnd, 0, 0, 0, 0);
+    SDL_RenderClear(window->rnd);
+    SDL_SetRenderTarget(window->rnd, target);
+}
+
 Buffer* graphics_new_buffer(Window* window, int width, int height) {
     if (!window) window = curr_window;
-    SDL_Texture* texture = SDL_CreateTexture(window->rnd, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, width, height);
-    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
-    return (void*)texture;
+    for (Buffer** curr = &window->free_buffers; *curr; curr = &(*curr)->next) {
+        if ((*curr)->width != width || (*curr)->height != height) continue;
+        Buffer* buffer = *curr;
+        *curr = buffer->next;
+        buffer_hits++;
+        clear_buffer(window, buffer);
+        return buffer;
+    }
+    buffer_misses++;
+    Buffer* buffer = malloc(sizeof(Buffer));
+    buffer->texture = SDL_CreateTexture(window->rnd, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    buffer->window = window;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->frame_scoped = false;
+    SDL_SetTextureScaleMode(buffer->texture, SDL_SCALEMODE_NEAREST);
+    clear_buffer(window, buffer);
+    return buffer;
+}
+
+Buffer* graphics_frame_buffer(Window* window, int width, int height) {
+    if (!window) window = curr_window;
+    Buffer* buffer = graphics_new_buffer(window, width, height);
+    buffer->frame_scoped = true;
+    buffer->next = window->frame_buffers;
+    window->frame_buffers = buffer;
+    return buffer;
 }
 
 void graphics_set_buffer(Window* window, Buffer* buffer) {
     if (!window) window = curr_window;
-    SDL_SetRenderTarget(window->rnd, (void*)buffer);
+    SDL_SetRenderTarget(window->rnd, buffer ? buffer->texture : NULL);
 }
 
 void graphics_destroy_buffer(Buffer* buffer) {
-    SDL_DestroyTexture((void*)buffer);
+    if (buffer->frame_scoped) return; // pooling it here too would link it into the free list twice
+    release_buffer(buffer->window, buffer);
+}
+
+// source rect in pixels of texture, appended as quad number count
+static void push_quad(SDL_Vertex* vertices, int* indices, int count, Texture* texture, float x, float y, float w, float h, float sx, float sy, float sw, float sh, SDL_FColor color) {
+    float u = sx / texture->width, v = sy / texture->height, u2 = (sx + sw) / texture->width, v2 = (sy + sh) / texture->height;
+    SDL_Vertex* quad = vertices + count * 4;
+    quad[0] = (SDL_Vertex){ { x,     y     }, color, { u,  v  } };
+    quad[1] = (SDL_Vertex){ { x + w, y     }, color, { u2, v  } };
+    quad[2] = (SDL_Vertex){ { x + w, y + h }, color, { u2, v2 } };
+    quad[3] = (SDL_Vertex){ { x,     y + h }, color, { u,  v2 } };
+    int* index = indices + count * 6;
+    index[0] = count * 4 + 0; index[1] = count * 4 + 1; index[2] = count * 4 + 2;
+    index[3] = count * 4 + 0; index[4] = count * 4 + 2; index[5] = count * 4 + 3;
+}
+
+static void draw_quads(Window* window, SDL_Texture* texture, SDL_Vertex* vertices, int* indices, int count) {
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    SDL_RenderGeometry(window->rnd, texture, vertices, count * 4, indices, count * 6);
+}
+
+static SDL_FColor vertex_color(Color color) {
+    return (SDL_FColor){ color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f };
+}
+
+// font is a grid of GLYPH_COLUMNS glyphs per row starting at ' ', every glyph becomes a quad of one geometry batch
+static void draw_glyphs(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    SDL_Texture* texture = get_texture(window, font, window->rnd);
+    int len = strlen(text);
+    if (!texture || len == 0) return;
+    // text comes from scripts and level files, too long to size on the stack
+    if (len > window->quads.capacity) {
+        while (len > window->quads.capacity) window->quads.capacity = window->quads.capacity == 0 ? 64 : window->quads.capacity * 2;
+        window->quads.vertices = realloc(window->quads.vertices, sizeof(SDL_Vertex) * 4 * window->quads.capacity);
+        window->quads.indices = realloc(window->quads.indices, sizeof(int) * 6 * window->quads.capacity);
+    }
+    SDL_Vertex* vertices = window->quads.vertices;
+    int* indices = window->quads.indices;
+    int count = 0;
+    for (int i = 0; i < len; i++) {
+        unsigned char c = text[i];
+        if (c < ' ') continue;
+        push_quad(vertices, indices, count++, font,
+            x + i * GLYPH_WIDTH * scale, y, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale,
+            (c % GLYPH_COLUMNS) * GLYPH_WIDTH, (c - ' ') / GLYPH_COLUMNS * GLYPH_HEIGHT, GLYPH_WIDTH, GLYPH_HEIGHT,
+            vertex_color(color)
+        );
+    }
+    draw_quads(window, texture, vertices, indices, count);
+}
+
+// stretches the source rect over the destination, the inset wide borders keep their size and only the edges and center stretch
+void graphics_nine_slice(Window* window, Texture* texture, float sx, float sy, float sw, float sh, float inset, float dx, float dy, float dw, float dh, Color color) {
+    if (!window) window = curr_window;
+    SDL_Texture* handle = get_texture(window, texture, window->rnd);
+    if (!handle) return;
+    SDL_Vertex vertices[9 * 4];
+    int indices[9 * 6];
+    float src_x[] = { sx, sx + inset, sx + sw - inset }, src_w[] = { inset, sw - inset * 2, inset };
+    float src_y[] = { sy, sy + inset, sy + sh - inset }, src_h[] = { inset, sh - inset * 2, inset };
+    float dst_x[] = { dx, dx + inset, dx + dw - inset }, dst_w[] = { inset, dw - inset * 2, inset };
+    float dst_y[] = { dy, dy + inset, dy + dh - inset }, dst_h[] = { inset, dh - inset * 2, inset };
+    int count = 0;
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 3; x++) {
+            push_quad(vertices, indices, count++, texture, dst_x[x], dst_y[y], dst_w[x], dst_h[y], src_x[x], src_y[y], src_w[x], src_h[y], vertex_color(color));
+        }
+    }
+    draw_quads(window, handle, vertices, indices, count);
+}
+
+void graphics_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    if (!window) window = curr_window;
+    draw_glyphs(window, font, x, y, scale, color, text);
+}
+
+// renders the text into a pooled buffer once and blits that on later calls with the same text, font, color and scale
+void graphics_static_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    if (!window) window = curr_window;
+    TextCacheEntry* entry = window->text_cache;
+    while (entry && (entry->font != font || entry->color.data != color.data || entry->scale != scale || strcmp(entry->text, text) != 0)) entry = entry->next;
+    if (!entry) {
+        int len = strlen(text);
+        if (len == 0) return;
+        entry = malloc(sizeof(TextCacheEntry));
+        entry->text = malloc(len + 1);
+        memcpy(entry->text, text, len + 1);
+        entry->font = font;
+        entry->color = color;
+        entry->scale = scale;
+        entry->buffer = graphics_new_buffer(window, len * GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale);
+        entry->next = window->text_cache;
+        window->text_cache = entry;
+        SDL_Texture* target = SDL_GetRenderTarget(window->rnd);
+        SDL_SetRenderTarget(window->rnd, entry->buffer->texture);
+        draw_glyphs(window, font, 0, 0, scale, color, text);
+        SDL_SetRenderTarget(window->rnd, target);
+    }
+    entry->last_used = window->frame;
+    Buffer* buffer = entry->buffer;
+    blit_texture(window, buffer->texture, x, y, buffer->width, buffer->height, 0, 0, buffer->width, buffer->height, RGBA(255, 255, 255, 255));
+}
+
+void graphics_buffer_stats(uint64_t* hits, uint64_t* misses) {
+    *hits = buffer_hits;
+    *misses = buffer_misses;
+}
+
+// out gets the buffer's pixels as r, g, b, a bytes, the same layout as Texture colors
+bool graphics_read_buffer(Window* window, Buffer* buffer, Color* out) {
+    if (!window) window = curr_window;
+    SDL_Texture* target = SDL_GetRenderTarget(window->rnd);
+    SDL_SetRenderTarget(window->rnd, buffer->texture);
+    SDL_Surface* surface = SDL_RenderReadPixels(window->rnd, NULL);
+    SDL_SetRenderTarget(window->rnd, target);
+    if (!surface) return false;
+    bool success = SDL_ConvertPixels(buffer->width, buffer->height, surface->format, surface->pixels, surface->pitch, SDL_PIXELFORMAT_RGBA32, out, buffer->width * sizeof(Color));
+    SDL_DestroySurface(surface);
+    return success;
 }
 
 void* loader_png(const char* filename, uint8_t* data, int len) {
     int c;
     Texture* texture = malloc(sizeof(Texture));
     texture->colors = (Color*)stbi_load_from_memory(data, len, &texture->width, &texture->height, &c, 4);
+    texture->slot = 0;
+    texture->generation = 0;
     return texture;
 }
 
+void register_png(void* data) {
+    if (data) register_texture(data);
+}
+
 bool graphics_should_close() {
     SDL_PumpEvents();
     return SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_EVENT_QUIT, SDL_EVENT_QUIT) > 0;
@@ -182,4 +477,5 @@ bool graphics_should_close() {
 
 void graphics_post_process(Window* w, Shader* shader) {}
 void graphics_set_shader(Window* w, Shader* shader) {}
+void graphics_set_uniform(Shader* shader, const char* name, float x, float y, float z, float w) {}
 void* loader_glsl(const char* filename, uint8_t* data, int len) { return NULL; }
@@ -0,0 +1,586 @@
+#include <SDL3/SDL.h>
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "io/graphics.h"
+#include "stb_image.h"
+
+// renders everything on the cpu. pixels are stored as r, g, b, a bytes like the textures stb_image decodes,
+// draws are queued per target and rasterized in TILE_SIZE tiles by worker threads when the target changes
+// or the frame ends. every pixel sees its draws in order, so the output is the same with any thread count.
+// selected with "graphics": "software" under backends in config.json.
+
+#define TILE_SIZE 64
+#define MAX_WORKERS 16
+#define GLYPH_WIDTH 6
+#define GLYPH_HEIGHT 8
+#define GLYPH_COLUMNS 16
+#define POOL_FRAMES 60 // pooled buffers unused for this many frames are freed
+#define POOL_SIZE 16 // at most this many buffers stay pooled, the ones given back last are kept
+#define HEADLESS_ENV "GRAPHICS_HEADLESS" // render to memory only, the value is how many frames to run
+#define HEADLESS_WIDTH 1920
+#define HEADLESS_HEIGHT 1080
+
+typedef struct {
+    const uint32_t* pixels; // NULL fills with color
+    int width, height;
+    float dx, dy, dw, dh, sx, sy, sw, sh;
+    uint8_t tint[4];
+    bool blend;
+    bool flip_x, flip_y; // drawn with a negative size, the source is mirrored over the normalized dst rect
+} DrawCommand;
+
+struct Buffer {
+    uint32_t* pixels;
+    Window* window;
+    int width, height;
+    uint64_t released; // frame it went back to the pool
+    bool frame_scoped; // given back by graphics_end_frame, graphics_destroy_buffer leaves it alone
+    Buffer* next;
+};
+
+struct Window {
+    SDL_Window* wnd;
+    float dpi_scale;
+    Buffer screen;
+    Buffer* target;
+    DrawCommand* commands;
+    int commands_size, commands_capacity;
+    Buffer* free_buffers;
+    Buffer* frame_buffers;
+    uint64_t frame;
+};
+
+static Window* curr_window = NULL;
+static uint64_t buffer_hits, buffer_misses;
+static int headless_frames = -1;
+static const uint32_t white_pixel = 0xFFFFFFFF;
+
+static struct {
+    Buffer* target;
+    const DrawCommand* commands;
+    int* bins;    // command indices of every tile, in draw order
+    int* offsets; // where each tile's indices start in bins
+    int tiles_x, num_tiles;
+    atomic_int next_tile;
+} job;
+
+static pthread_mutex_t workers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workers_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t workers_done = PTHREAD_COND_INITIALIZER;
+static int num_workers = -1, workers_busy;
+static unsigned job_generation;
+
+static inline unsigned div255(unsigned x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// src is tinted, then blended over dst like SDL_BLENDMODE_BLEND
+static inline void blend_pixel(const uint8_t* src, uint8_t* dst, const uint8_t* tint) {
+    unsigned s[4];
+    for (int c = 0; c < 4; c++) s[c] = div255(src[c] * tint[c]);
+    unsigned inv = 255 - s[3];
+    for (int c = 0; c < 3; c++) dst[c] = div255(s[c] * s[3] + dst[c] * inv);
+    dst[3] = div255(s[3] * 255 + dst[3] * inv);
+}
+
+#ifdef __SSE2__
+static inline __m128i div255_epi16(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// same math as blend_pixel on two pixels widened to 16 bit lanes
+static inline __m128i blend_epi16(__m128i src, __m128i dst, __m128i tint) {
+    __m128i alpha_lanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i s = div255_epi16(_mm_mullo_epi16(src, tint));
+    __m128i sa = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), sa);
+    __m128i mult = _mm_or_si128(_mm_andnot_si128(alpha_lanes, sa), _mm_and_si128(alpha_lanes, _mm_set1_epi16(255)));
+    return div255_epi16(_mm_add_epi16(_mm_mullo_epi16(s, mult), _mm_mullo_epi16(dst, inv)));
+}
+
+static inline __m128i blend_4(__m128i src, __m128i dst, __m128i tint) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = blend_epi16(_mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(dst, zero), tint);
+    __m128i hi = blend_epi16(_mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(dst, zero), tint);
+    return _mm_packus_epi16(lo, hi);
+}
+#endif
+
+// first and one past last pixel whose center lies in [from, from + size)
+static void pixel_span(float from, float size, int min, int max, int* start, int* end) {
+    *start = (int)ceilf(from - 0.5f);
+    *end = (int)ceilf(from + size - 0.5f);
+    if (*start < min) *start = min;
+    if (*end > max) *end = max;
+}
+
+static void raster_command(Buffer* target, const DrawCommand* cmd, int min_x, int min_y, int max_x, int max_y) {
+    int x0, x1, y0, y1;
+    pixel_span(cmd->dx, cmd->dw, min_x, max_x, &x0, &x1);
+    pixel_span(cmd->dy, cmd->dh, min_y, max_y, &y0, &y1);
+    if (x0 >= x1 || y0 >= y1) return;
+    if (!cmd->blend) {
+        uint32_t color;
+        memcpy(&color, cmd->tint, sizeof(color));
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) target->pixels[y * target->width + x] = color;
+        }
+        return;
+    }
+    const uint32_t* pixels = cmd->pixels ? cmd->pixels : &white_pixel;
+    int width = cmd->pixels ? cmd->width : 1, height = cmd->pixels ? cmd->height : 1;
+    float scale_x = cmd->sw / cmd->dw, scale_y = cmd->sh / cmd->dh;
+    int columns[TILE_SIZE];
+    for (int x = x0; x < x1; x++) {
+        float offset = (x + 0.5f - cmd->dx) * scale_x;
+        int column = cmd->pixels ? (int)floorf(cmd->flip_x ? cmd->sx + cmd->sw - offset : cmd->sx + offset) : 0;
+        columns[x - x0] = column < 0 ? 0 : column >= width ? width - 1 : column;
+    }
+#ifdef __SSE2__
+    __m128i tint = _mm_set_epi16(cmd->tint[3], cmd->tint[2], cmd->tint[1], cmd->tint[0], cmd->tint[3], cmd->tint[2], cmd->tint[1], cmd->tint[0]);
+#endif
+    for (int y = y0; y < y1; y++) {
+        float offset = (y + 0.5f - cmd->dy) * scale_y;
+        int row = cmd->pixels ? (int)floorf(cmd->flip_y ? cmd->sy + cmd->sh - offset : cmd->sy + offset) : 0;
+        row = row < 0 ? 0 : row >= height ? height - 1 : row;
+        const uint32_t* src = pixels + row * width;
+        uint32_t* dst = target->pixels + y * target->width;
+        int x = x0;
+#ifdef __SSE2__
+        for (; x + 4 <= x1; x += 4) {
+            const int* column = columns + (x - x0);
+            __m128i texels = _mm_set_epi32(src[column[3]], src[column[2]], src[column[1]], src[column[0]]);
+            __m128i* out = (__m128i*)(dst + x);
+            _mm_storeu_si128(out, blend_4(texels, _mm_loadu_si128(out), tint));
+        }
+#endif
+        for (; x < x1; x++) blend_pixel((const uint8_t*)&src[columns[x - x0]], (uint8_t*)&dst[x], cmd->tint);
+    }
+}
+
+static void raster_tiles() {
+    int tile;
+    while ((tile = atomic_fetch_add(&job.next_tile, 1)) < job.num_tiles) {
+        int min_x = tile % job.tiles_x * TILE_SIZE, min_y = tile / job.tiles_x * TILE_SIZE;
+        int max_x = min_x + TILE_SIZE < job.target->width ? min_x + TILE_SIZE : job.target->width;
+        int max_y = min_y + TILE_SIZE < job.target->height ? min_y + TILE_SIZE : job.target->height;
+        for (int i = job.offsets[tile]; i < job.offsets[tile + 1]; i++) {
+            raster_command(job.target, &job.commands[job.bins[i]], min_x, min_y, max_x, max_y);
+        }
+    }
+}
+
+static void* raster_worker(void* arg) {
+    unsigned seen = 0;
+    while (true) {
+        pthread_mutex_lock(&workers_mutex);
+        while (job_generation == seen) pthread_cond_wait(&workers_start, &workers_mutex);
+        seen = job_generation;
+        pthread_mutex_unlock(&workers_mutex);
+        raster_tiles();
+        pthread_mutex_lock(&workers_mutex);
+        if (--workers_busy == 0) pthread_cond_signal(&workers_done);
+        pthread_mutex_unlock(&workers_mutex);
+    }
+    return NULL;
+}
+
+static void start_workers() {
+    int cores = SDL_GetNumLogicalCPUCores();
+    num_workers = 0;
+    for (int i = 0; i < cores - 1 && i < MAX_WORKERS; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, raster_worker, NULL) != 0) break;
+        pthread_detach(thread);
+        num_workers++;
+    }
+}
+
+static bool tile_range(Buffer* target, const DrawCommand* cmd, int* from_x, int* from_y, int* to_x, int* to_y) {
+    int x0, x1, y0, y1;
+    pixel_span(cmd->dx, cmd->dw, 0, target->width, &x0, &x1);
+    pixel_span(cmd->dy, cmd->dh, 0, target->height, &y0, &y1);
+    if (x0 >= x1 || y0 >= y1) return false;
+    *from_x = x0 / TILE_SIZE;
+    *from_y = y0 / TILE_SIZE;
+    *to_x = (x1 - 1) / TILE_SIZE;
+    *to_y = (y1 - 1) / TILE_SIZE;
+    return true;
+}
+
+static void flush(Window* window) {
+    if (window->commands_size == 0) return;
+    static int* bins;
+    static int* offsets;
+    static int bins_capacity, offsets_capacity;
+    Buffer* target = window->target;
+    int tiles_x = (target->width + TILE_SIZE - 1) / TILE_SIZE;
+    int num_tiles = tiles_x * ((target->height + TILE_SIZE - 1) / TILE_SIZE);
+    if (offsets_capacity < num_tiles + 1) {
+        offsets_capacity = num_tiles + 1;
+        offsets = realloc(offsets, sizeof(int) * offsets_capacity);
+    }
+    memset(offsets, 0, sizeof(int) * (num_tiles + 1));
+
+    // count the commands of every tile, turn the counts into offsets, then fill the bins in draw order
+    int from_x, from_y, to_x, to_y, total = 0;
+    for (int i = 0; i < window->commands_size; i++) {
+        if (!tile_range(target, &window->commands[i], &from_x, &from_y, &to_x, &to_y)) continue;
+        for (int y = from_y; y <= to_y; y++) {
+            for (int x = from_x; x <= to_x; x++) offsets[y * tiles_x + x + 1]++;
+        }
+        total += (to_x - from_x + 1) * (to_y - from_y + 1);
+    }
+    for (int i = 0; i < num_tiles; i++) offsets[i + 1] += offsets[i];
+    if (bins_capacity < total) {
+        bins_capacity = total;
+        bins = realloc(bins, sizeof(int) * bins_capacity);
+    }
+    int fill[num_tiles];
+    memcpy(fill, offsets, sizeof(int) * num_tiles);
+    for (int i = 0; i < window->commands_size; i++) {
+        if (!tile_range(target, &window->commands[i], &from_x, &from_y, &to_x, &to_y)) continue;
+        for (int y = from_y; y <= to_y; y++) {
+            for (int x = from_x; x <= to_x; x++) bins[fill[y * tiles_x + x]++] = i;
+        }
+    }
+
+    job.target = target;
+    job.commands = window->commands;
+    job.bins = bins;
+    job.offsets = offsets;
+    job.tiles_x = tiles_x;
+    job.num_tiles = num_tiles;
+    atomic_store(&job.next_tile, 0);
+    if (num_workers < 0) start_workers();
+    if (num_workers > 0 && num_tiles > 1) {
+        pthread_mutex_lock(&workers_mutex);
+        workers_busy = num_workers;
+        job_generation++;
+        pthread_cond_broadcast(&workers_start);
+        pthread_mutex_unlock(&workers_mutex);
+        raster_tiles();
+        pthread_mutex_lock(&workers_mutex);
+        while (workers_busy > 0) pthread_cond_wait(&workers_done, &workers_mutex);
+        pthread_mutex_unlock(&workers_mutex);
+    }
+    else raster_tiles();
+    window->commands_size = 0;
+}
+
+static void push_command(Window* window, DrawCommand cmd) {
+    if (cmd.dw < 0) {
+        cmd.dx += cmd.dw;
+        cmd.dw = -cmd.dw;
+        cmd.flip_x = true;
+    }
+    if (cmd.dh < 0) {
+        cmd.dy += cmd.dh;
+        cmd.dh = -cmd.dh;
+        cmd.flip_y = true;
+    }
+    if (cmd.dw == 0 || cmd.dh == 0) return;
+    if (window->target == &window->screen) {
+        cmd.dx *= window->dpi_scale;
+        cmd.dy *= window->dpi_scale;
+        cmd.dw *= window->dpi_scale;
+        cmd.dh *= window->dpi_scale;
+    }
+    if (window->commands_size == window->commands_capacity) {
+        window->commands_capacity = window->commands_capacity == 0 ? 256 : window->commands_capacity * 2;
+        window->commands = realloc(window->commands, sizeof(DrawCommand) * window->commands_capacity);
+    }
+    window->commands[window->commands_size++] = cmd;
+}
+
+static void push_texture(Window* window, const uint32_t* pixels, int width, int height, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    push_command(window, (DrawCommand){
+        .pixels = pixels, .width = width, .height = height,
+        .dx = dx, .dy = dy, .dw = dw, .dh = dh,
+        .sx = sx, .sy = sy, .sw = sw, .sh = sh,
+        .tint = { color.r, color.g, color.b, color.a },
+        .blend = true,
+    });
+}
+
+static void init_video() {
+    static bool inited = false;
+    if (inited) return;
+    inited = true;
+    const char* headless = getenv(HEADLESS_ENV);
+    if (headless) headless_frames = atoi(headless);
+    else SDL_Init(SDL_INIT_VIDEO);
+}
+
+static void free_buffers(Buffer* buffer) {
+    while (buffer) {
+        Buffer* next = buffer->next;
+        free(buffer->pixels);
+        free(buffer);
+        buffer = next;
+    }
+}
+
+static void release_buffer(Window* window, Buffer* buffer) {
+    buffer->frame_scoped = false;
+    buffer->released = window->frame;
+    buffer->next = window->free_buffers;
+    window->free_buffers = buffer;
+}
+
+// frees pooled buffers that went unused for too long or don't fit, buffers are pushed so the list is newest first
+static void trim_pool(Window* window) {
+    int kept = 0;
+    for (Buffer** curr = &window->free_buffers; *curr;) {
+        Buffer* buffer = *curr;
+        if (kept < POOL_SIZE && window->frame - buffer->released <= POOL_FRAMES) {
+            kept++;
+            curr = &buffer->next;
+            continue;
+        }
+        *curr = buffer->next;
+        buffer->next = NULL;
+        free_buffers(buffer);
+    }
+}
+
+Window* graphics_open(const char* title, int width, int height) {
+    init_video();
+
+    Window* w = calloc(1, sizeof(Window));
+    int window_width = width, window_height = height;
+    if (headless_frames < 0) {
+        w->wnd = SDL_CreateWindow(title, width, height, 0);
+        SDL_HideCursor();
+        SDL_GetWindowSize(w->wnd, &window_width, &window_height);
+    }
+    w->dpi_scale = window_width / (float)width;
+    w->screen.pixels = calloc(window_width * window_height, sizeof(uint32_t));
+    w->screen.window = w;
+    w->screen.width = window_width;
+    w->screen.height = window_height;
+    w->target = &w->screen;
+    curr_window = w;
+    return w;
+}
+
+void graphics_close(Window* w) {
+    if (!w) w = curr_window;
+    free_buffers(w->free_buffers);
+    free_buffers(w->frame_buffers);
+    free(w->screen.pixels);
+    free(w->commands);
+    if (w->wnd) SDL_DestroyWindow(w->wnd);
+}
+
+void graphics_focus(Window* w) {
+    if (!w) w = curr_window;
+    if (w->wnd) SDL_RaiseWindow(w->wnd);
+}
+
+void graphics_get_size(Window* w, int* width, int* height) {
+    if (!w) w = curr_window;
+    *width = w->screen.width;
+    *height = w->screen.height;
+}
+
+void graphics_get_pos(Window* w, int* x, int* y) {
+    if (!w) w = curr_window;
+    *x = *y = 0;
+    if (w->wnd) SDL_GetWindowPosition(w->wnd, x, y);
+}
+
+void graphics_screen_size(int* x, int* y) {
+    init_video();
+
+    if (headless_frames >= 0) {
+        *x = HEADLESS_WIDTH;
+        *y = HEADLESS_HEIGHT;
+        return;
+    }
+    const SDL_DisplayMode* dm = SDL_GetCurrentDisplayMode(SDL_GetDisplays(NULL)[0]);
+    *x = dm->w;
+    *y = dm->h;
+}
+
+float graphics_get_dpi_scale(Window* w) {
+    if (!w) w = curr_window;
+    return w->dpi_scale;
+}
+
+// headless windows never wait
+bool graphics_set_vsync(Window* w, int interval) {
+    if (!w) w = curr_window;
+    if (!w->wnd) return interval == 0;
+    return SDL_SetWindowSurfaceVSync(w->wnd, interval);
+}
+
+float graphics_refresh_rate(Window* w) {
+    if (!w) w = curr_window;
+    if (!w->wnd) return 0;
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(w->wnd));
+    return mode ? mode->refresh_rate : 0;
+}
+
+void graphics_set_active(Window* w) {
+    curr_window = w;
+}
+
+void graphics_start_frame(Window* w) {
+    if (!w) w = curr_window;
+    push_command(w, (DrawCommand){
+        .dw = w->screen.width / w->dpi_scale, .dh = w->screen.height / w->dpi_scale,
+        .tint = { 0, 0, 0, 255 },
+    });
+}
+
+void graphics_end_frame(Window* w) {
+    if (!w) w = curr_window;
+    flush(w);
+    if (w->wnd) {
+        SDL_Surface* surface = SDL_CreateSurfaceFrom(w->screen.width, w->screen.height, SDL_PIXELFORMAT_ABGR8888, w->screen.pixels, w->screen.width * sizeof(uint32_t));
+        SDL_BlitSurface(surface, NULL, SDL_GetWindowSurface(w->wnd), NULL);
+        SDL_UpdateWindowSurface(w->wnd);
+        SDL_DestroySurface(surface);
+    }
+    else if (headless_frames > 0) headless_frames--;
+    while (w->frame_buffers) {
+        Buffer* next = w->frame_buffers->next;
+        release_buffer(w, w->frame_buffers);
+        w->frame_buffers = next;
+    }
+    w->frame++;
+    trim_pool(w);
+}
+
+void graphics_rect(Window* window, float x, float y, float w, float h, Color color) {
+    if (!window) window = curr_window;
+    push_texture(window, NULL, 1, 1, x, y, w, h, 0, 0, 1, 1, color);
+}
+
+void graphics_draw(Window* window, Texture* texture, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    if (!texture || !texture->colors) return;
+    push_texture(window, (uint32_t*)texture->colors, texture->width, texture->height, dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+void graphics_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    if (!window) window = curr_window;
+    for (int i = 0; text[i]; i++) {
+        unsigned char c = text[i];
+        if (c < ' ') continue;
+        graphics_draw(window, font,
+            x + i * GLYPH_WIDTH * scale, y, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale,
+            (c % GLYPH_COLUMNS) * GLYPH_WIDTH, (c - ' ') / GLYPH_COLUMNS * GLYPH_HEIGHT, GLYPH_WIDTH, GLYPH_HEIGHT,
+            color
+        );
+    }
+}
+
+// queued glyphs cost about as much as blitting a cached buffer here
+void graphics_static_text(Window* window, Texture* font, float x, float y, int scale, Color color, const char* text) {
+    graphics_text(window, font, x, y, scale, color, text);
+}
+
+void graphics_nine_slice(Window* window, Texture* texture, float sx, float sy, float sw, float sh, float inset, float dx, float dy, float dw, float dh, Color color) {
+    if (!window) window = curr_window;
+    float src_x[] = { sx, sx + inset, sx + sw - inset }, src_w[] = { inset, sw - inset * 2, inset };
+    float src_y[] = { sy, sy + inset, sy + sh - inset }, src_h[] = { inset, sh - inset * 2, inset };
+    float dst_x[] = { dx, dx + inset, dx + dw - inset }, dst_w[] = { inset, dw - inset * 2, inset };
+    float dst_y[] = { dy, dy + inset, dy + dh - inset }, dst_h[] = { inset, dh - inset * 2, inset };
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 3; x++) {
+            graphics_draw(window, texture, dst_x[x], dst_y[y], dst_w[x], dst_h[y], src_x[x], src_y[y], src_w[x], src_h[y], color);
+        }
+    }
+}
+
+void graphics_blit(Window* window, Buffer* buffer, float dx, float dy, float dw, float dh, float sx, float sy, float sw, float sh, Color color) {
+    if (!window) window = curr_window;
+    push_texture(window, buffer->pixels, buffer->width, buffer->height, dx, dy, dw, dh, sx, sy, sw, sh, color);
+}
+
+Buffer* graphics_new_buffer(Window* window, int width, int height) {
+    if (!window) window = curr_window;
+    for (Buffer** curr = &window->free_buffers; *curr; curr = &(*curr)->next) {
+        if ((*curr)->width != width || (*curr)->height != height) continue;
+        Buffer* buffer = *curr;
+        *curr = buffer->next;
+        buffer_hits++;
+        memset(buffer->pixels, 0, sizeof(uint32_t) * width * height); // pooled buffers still hold what their last user drew
+        return buffer;
+    }
+    buffer_misses++;
+    Buffer* buffer = malloc(sizeof(Buffer));
+    buffer->pixels = calloc(width * height, sizeof(uint32_t));
+    buffer->window = window;
+    buffer->width = width;
+    buffer->height = height;
+    buffer->frame_scoped = false;
+    return buffer;
+}
+
+Buffer* graphics_frame_buffer(Window* window, int width, int height) {
+    if (!window) window = curr_window;
+    Buffer* buffer = graphics_new_buffer(window, width, height);
+    buffer->frame_scoped = true;
+    buffer->next = window->frame_buffers;
+    window->frame_buffers = buffer;
+    return buffer;
+}
+
+void graphics_set_buffer(Window* window, Buffer* buffer) {
+    if (!window) window = curr_window;
+    flush(window);
+    window->target = buffer ? buffer : &window->screen;
+}
+
+void graphics_destroy_buffer(Buffer* buffer) {
+    if (buffer->frame_scoped) return; // pooling it here too would link it into the free list twice
+    release_buffer(buffer->window, buffer);
+}
+
+void graphics_buffer_stats(uint64_t* hits, uint64_t* misses) {
+    *hits = buffer_hits;
+    *misses = buffer_misses;
+}
+
+bool graphics_read_buffer(Window* window, Buffer* buffer, Color* out) {
+    if (!window) window = curr_window;
+    if (window->target == buffer) flush(window);
+    memcpy(out, buffer->pixels, sizeof(uint32_t) * buffer->width * buffer->height);
+    return true;
+}
+
+void* loader_png(const char* filename, uint8_t* data, int len) {
+    int c;
+    Texture* texture = malloc(sizeof(Texture));
+    texture->colors = (Color*)stbi_load_from_memory(data, len, &texture->width, &texture->height, &c, 4);
+    texture->slot = 0;
+    texture->generation = 0;
+    return texture;
+}
+
+void register_png(void* data) {}
+
+bool graphics_should_close() {
+    if (headless_frames >= 0) return headless_frames == 0;
+    SDL_PumpEvents();
+    return SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_EVENT_QUIT, SDL_EVENT_QUIT) > 0;
+}
+
+void graphics_post_process(Window* w, Shader* shader) {}
+void graphics_set_shader(Window* w, Shader* shader) {}
+void graphics_set_uniform(Shader* shader, const char* name, float x, float y, float z, float w) {}
+void* loader_glsl(const char* filename, uint8_t* data, int len) { return NULL; }
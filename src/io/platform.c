@@ -2,7 +2,30 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
 
 uint64_t get_micros() { return 0; }
+uint64_t get_nanos() { return 0; }
+void sleep_nanos(uint64_t nanos) {}
 void watch_file(const char* filename, FileWatchCallback callback) {}
 void check_watched_files() {}
+
+void* map_file(const char* filename, size_t* length) {
+    FILE* f = fopen(filename, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* bytes = malloc(*length);
+    fread(bytes, *length, 1, f);
+    fclose(f);
+    return bytes;
+}
+
+void unmap_file(void* data, size_t length) {
+    free(data);
+}
+
+bool make_dir(const char* path) { return false; }
+int cpu_count() { return 1; }
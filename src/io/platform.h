@@ -2,13 +2,22 @@
 #define PLATFORM_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 typedef void(*FileWatchCallback)(const char* filename);
 
 uint64_t get_micros();
+uint64_t get_nanos(); // monotonic, only meaningful as a difference
+void sleep_nanos(uint64_t nanos);
 
 void watch_file(const char* filename, FileWatchCallback callback);
 void check_watched_files();
 
+void* map_file(const char* filename, size_t* length);
+void unmap_file(void* data, size_t length);
+
+bool make_dir(const char* path); // true if the directory exists afterwards
+int cpu_count();
+
 #endif
@@ -1,9 +1,13 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <sys/time.h>
 #include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "io/platform.h"
@@ -29,6 +33,17 @@ uint64_t get_micros() {
     return tv.tv_sec * 1000000 + tv.tv_usec;
 }
 
+uint64_t get_nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void sleep_nanos(uint64_t nanos) {
+    struct timespec ts = { nanos / 1000000000, nanos % 1000000000 };
+    nanosleep(&ts, NULL);
+}
+
 void watch_file(const char* filename, FileWatchCallback callback) {
     if (inotify_fd == -1) inotify_fd = inotify_init1(IN_NONBLOCK);
     int wd = inotify_add_watch(inotify_fd, filename, IN_MODIFY | IN_DONT_FOLLOW);
@@ -60,3 +75,32 @@ void check_watched_files() {
         }
     }
 }
+
+void* map_file(const char* filename, size_t* length) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return NULL;
+    }
+    void* data = st.st_size == 0 ? MAP_FAILED : mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    *length = st.st_size;
+    return data;
+}
+
+void unmap_file(void* data, size_t length) {
+    if (data) munmap(data, length);
+}
+
+bool make_dir(const char* path) {
+    struct stat st;
+    return mkdir(path, 0755) == 0 || (stat(path, &st) == 0 && S_ISDIR(st.st_mode));
+}
+
+int cpu_count() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
@@ -11,3 +11,49 @@ uint64_t get_micros() {
     QueryPerformanceCounter(&counter);
     return (counter.QuadPart * 1000000) / freq.QuadPart;
 }
+
+// split so the multiplication doesn't overflow after a few minutes of uptime
+uint64_t get_nanos() {
+    static LARGE_INTEGER freq = {};
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / freq.QuadPart * 1000000000 + counter.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart;
+}
+
+// only millisecond granularity, callers that need more spin for the rest
+void sleep_nanos(uint64_t nanos) {
+    Sleep(nanos / 1000000);
+}
+
+void* map_file(const char* filename, size_t* length) {
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data) *length = size.QuadPart;
+    return data;
+}
+
+void unmap_file(void* data, size_t length) {
+    if (data) UnmapViewOfFile(data);
+}
+
+bool make_dir(const char* path) {
+    return CreateDirectoryA(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+int cpu_count() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
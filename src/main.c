@@ -1,10 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdarg.h>
 #include <string.h>
+#include <inttypes.h>
 
 #include "main.h"
 #include "storage.h"
+#include "reload.h"
+#include "capture.h"
+#include "pacing.h"
 
 #include "io/assets.h"
 #include "io/graphics.h"
@@ -20,67 +23,207 @@ static Window* window;
 jitc_context_t* jitc_context;
 static bool compilation_failed = false;
 static bool editor_mode_enabled = false;
+static bool profile_enabled = false;
+typedef struct {
+    const char* code;
+    const char* filename;
+} CompileJob;
 
-#ifdef _WIN32
-int vasprintf(char** out, const char* fmt, va_list args) {
-    va_list args2;
-    va_copy(args2, args);
-    int len = snprintf(NULL, 0, fmt, args2);
-    va_end(args2);
-    *out = malloc(len + 1);
-    sprintf(*out, fmt, args);
-    return len;
+static int num_compile_jobs, compile_jobs_capacity;
+static CompileJob* compile_jobs;
+
+static uint64_t scripts_hash = 0xcbf29ce484222325; // fnv-1a over every header and source handed to jitc
+
+#define STARTUP_LOG "startup.log"
+
+static void draw_text(Window* window, Texture* font, float anchor, int x, int y, Color color, const char* text) {
+    graphics_text(window, font, x - strlen(text) * 6 * anchor, y, 1, color, text);
 }
+
+#ifndef PROGRESS_INTERVAL
+#define PROGRESS_INTERVAL 33000 // redraw at most this often, every frame waits for vsync, 0 redraws for every unit
 #endif
 
-static void draw_text(Window* window, float anchor, int x, int y, Color color, const char* fmt, ...) {
-    char *string, *ptr;
-    va_list args;
-    va_start(args, fmt);
-    vasprintf(&string, fmt, args);
-    va_end(args);
-    ptr = string;
-
-    char c;
-    int pos_x = x - strlen(string) * 6 * anchor, pos_y = y;
-    Texture* texture = get_asset(Texture, "images/hud/font.png");
-    while ((c = *ptr++)) {
-        int x = c % 16;
-        int y = c / 16 - 2;
-        graphics_draw(window, texture, pos_x, pos_y, 6, 8, x * 6, y * 8, 6, 8, color);
-        pos_x += 6;
-    }
-    free(string);
+static int num_redraws, num_progress_units;
+static uint64_t redraw_micros; // time spent drawing the progress window, vsync included
+
+typedef struct {
+    const char* file;
+    uint64_t micros;
+} UnitTime;
+
+static int num_unit_times;
+static UnitTime* unit_times;
+
+static int compare_unit_time(const void* a, const void* b) {
+    uint64_t x = ((UnitTime*)a)->micros, y = ((UnitTime*)b)->micros;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+// a unit's time runs from its progress callback to the next one, not counting the redraw in between
+static void record_unit_time(const char* curr_file, int total, uint64_t now) {
+    static const char* prev_file;
+    static uint64_t prev_start;
+    if (!unit_times) unit_times = malloc(sizeof(UnitTime) * (total + 1));
+    if (prev_file && num_unit_times < total) unit_times[num_unit_times++] = (UnitTime){ prev_file, now - prev_start };
+    prev_file = curr_file;
+    prev_start = get_micros();
 }
 
 static void compile_progress(const char* curr_file, int total, int compiled) {
+    static uint64_t last_redraw;
+    uint64_t now = get_micros();
+    num_progress_units = total;
+    if (curr_file && compiled != 0 && now - last_redraw < PROGRESS_INTERVAL) {
+        record_unit_time(curr_file, total, now);
+        return;
+    }
+    last_redraw = now;
+    num_redraws++;
     graphics_start_frame(window);
     float percent = compiled / (float)total;
     graphics_rect(window, 0, 0, 256, 64, GRAY(32));
-    draw_text(window, 0.5, 128, 4, GRAY(255), "Compiling scripts...");
-    draw_text(window, 0.0, 4, 44, GRAY(255), curr_file ?: "Done");
-    draw_text(window, 1.0, 252, 44, GRAY(255), "%3d%%", compiled * 100 / total);
+    static Texture* font;
+    if (!font) font = get_asset(Texture, "images/hud/font.png");
+    char percent_text[8];
+    snprintf(percent_text, sizeof(percent_text), "%3d%%", compiled * 100 / total);
+    draw_text(window, font, 0.5, 128, 4, GRAY(255), "Compiling scripts...");
+    draw_text(window, font, 0.0, 4, 44, GRAY(255), curr_file ?: "Done");
+    draw_text(window, font, 1.0, 252, 44, GRAY(255), percent_text);
     graphics_rect(window, 0, 56, compiled * 256.f / total, 8, RGB(0, 192, 0));
     graphics_end_frame(window);
+    redraw_micros += get_micros() - now;
+    record_unit_time(curr_file, total, now);
+}
+
+#define SLOWEST_UNITS 5
+#define SHARED_UNIT "scripts/engine.c"
+
+// measured times only, --profile lists every unit instead of the slowest ones,
+// the units that depend on engine.c are summed up since each of them parses its declarations again
+static void report_unit_times() {
+    if (num_unit_times == 0) return;
+    printf("Progress window: %d redraws for %d units, %.2f ms\n", num_redraws, num_progress_units, redraw_micros / 1000.f);
+    qsort(unit_times, num_unit_times, sizeof(UnitTime), compare_unit_time);
+    int count = profile_enabled || num_unit_times < SLOWEST_UNITS ? num_unit_times : SLOWEST_UNITS;
+    printf(profile_enabled ? "Unit times:" : "Slowest units:");
+    for (int i = 0; i < count; i++) printf(" %s %.2f ms%s", unit_times[i].file, unit_times[i].micros / 1000.f, i + 1 < count ? "," : "\n");
+    int num_dependents = 0;
+    uint64_t total = 0, dependents = 0;
+    for (int i = 0; i < num_unit_times; i++) {
+        total += unit_times[i].micros;
+        if (!reload_depends(unit_times[i].file, SHARED_UNIT)) continue;
+        num_dependents++;
+        dependents += unit_times[i].micros;
+    }
+    if (num_dependents > 0) printf("%d of %d units depend on %s, %.2f ms of %.2f ms\n",
+        num_dependents, num_unit_times, SHARED_UNIT, dependents / 1000.f, total / 1000.f
+    );
 }
 
-static void recompile_file(const char* file) {
-    uint64_t start = get_micros();
-    printf("Reloading '%s'...", file);
-    if (!jitc_parse_file(jitc_context, file)) jitc_report_error(jitc_context, stdout);
-    else printf("%.2f ms\n", (get_micros() - start) / 1000.f);
+void hash_compile_input(const char* filename, const char* code) {
+    for (const char* c = filename; *c; c++) scripts_hash = (scripts_hash ^ (uint8_t)*c) * 0x100000001b3;
+    scripts_hash = (scripts_hash ^ 0) * 0x100000001b3;
+    for (const char* c = code; *c; c++) scripts_hash = (scripts_hash ^ (uint8_t)*c) * 0x100000001b3;
+    scripts_hash = (scripts_hash ^ 0) * 0x100000001b3;
 }
 
-void add_compile_job(const char* code, const char* filename) {
-    if (!jitc_append_task(jitc_context, code, filename)) {
-        compilation_failed = true;
-        jitc_report_error(jitc_context, stdout);
+// returns the script hash of the previous launch, 0 if there wasn't one
+static uint64_t read_last_scripts_hash() {
+    FILE* f = fopen(STARTUP_LOG, "r");
+    if (!f) return 0;
+    char line[256];
+    uint64_t hash = 0, curr;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%" SCNx64, &curr) == 1) hash = curr;
+    }
+    fclose(f);
+    return hash;
+}
+
+// the hash only says whether the scripts match the last profiled launch, it doesn't know
+// whether any cache was warm, so runs are labeled by their inputs
+static void report_startup(uint64_t assets_time, uint64_t build_time, uint64_t total_time) {
+    if (!profile_enabled) {
+        printf("Startup: assets %.2f ms, scripts %.2f ms, total %.2f ms\n",
+            assets_time / 1000.f, build_time / 1000.f, total_time / 1000.f
+        );
         return;
     }
+    bool changed = read_last_scripts_hash() != scripts_hash;
+    printf("Startup (%s inputs): assets %.2f ms, scripts %.2f ms, total %.2f ms\n", changed ? "changed" : "unchanged",
+        assets_time / 1000.f, build_time / 1000.f, total_time / 1000.f
+    );
+    FILE* f = fopen(STARTUP_LOG, "a");
+    if (!f) return;
+    fprintf(f, "%016" PRIx64 " %s %.2f %.2f %.2f\n", scripts_hash, changed ? "changed" : "unchanged",
+        assets_time / 1000.f, build_time / 1000.f, total_time / 1000.f
+    );
+    fclose(f);
+}
+
+// jobs are held back until every script is registered, the #depends graph decides which ones get deferred
+void add_compile_job(const char* code, const char* filename) {
+    hash_compile_input(filename, code);
+    if (num_compile_jobs == compile_jobs_capacity) {
+        compile_jobs_capacity = compile_jobs_capacity == 0 ? 16 : compile_jobs_capacity * 2;
+        compile_jobs = realloc(compile_jobs, sizeof(CompileJob) * compile_jobs_capacity);
+    }
+    compile_jobs[num_compile_jobs++] = (CompileJob){ code, filename };
+    reload_register(filename, code, false);
     char path[sizeof("assets/") + strlen(filename)];
     strcpy(path, "assets/");
     strcat(path, filename);
-    watch_file(strdup(path), recompile_file);
+    watch_file(strdup(path), reload_file);
+}
+
+static void submit_compile_jobs() {
+    for (int i = 0; i < num_compile_jobs; i++) {
+        if (reload_is_deferred(compile_jobs[i].filename)) {
+            free((char*)compile_jobs[i].code);
+            continue;
+        }
+        if (!jitc_append_task(jitc_context, compile_jobs[i].code, compile_jobs[i].filename)) {
+            compilation_failed = true;
+            jitc_report_error(jitc_context, stdout);
+            break;
+        }
+    }
+    free(compile_jobs);
+    compile_jobs = NULL;
+    num_compile_jobs = compile_jobs_capacity = 0;
+}
+
+void add_header(const char* code, const char* filename) {
+    hash_compile_input(filename, code);
+    jitc_create_header(jitc_context, filename, code);
+    reload_register(filename, code, true);
+    char path[sizeof("assets/") + strlen(filename)];
+    strcpy(path, "assets/");
+    strcat(path, filename);
+    watch_file(strdup(path), reload_file);
+}
+
+#define PROFILE_ENTRIES 24
+#define HOT_CALLS_PER_FRAME 64 // callbacks above this would be worth optimizing further
+
+static void report_profile() {
+    void* funcs[PROFILE_ENTRIES];
+    uint64_t calls[PROFILE_ENTRIES];
+    int count = PROFILE_ENTRIES;
+    uint64_t frames = engine_profile_results(funcs, calls, &count);
+    if (frames == 0) frames = 1;
+    printf("Script callbacks over %" PRIu64 " frames:\n", frames);
+    for (int i = 0; i < count; i++) {
+        const char* name = reload_symbol_name(funcs[i]);
+        float per_frame = calls[i] / (float)frames;
+        printf("  %12" PRIu64 " calls %10.1f/frame  %s ", calls[i], per_frame, per_frame >= HOT_CALLS_PER_FRAME ? "hot " : "    ");
+        if (name) printf("%s\n", name);
+        else printf("%p\n", funcs[i]);
+    }
+    uint64_t hits, misses;
+    graphics_buffer_stats(&hits, &misses);
+    printf("Render targets: %" PRIu64 " reused, %" PRIu64 " created\n", hits, misses);
 }
 
 #ifdef _WIN32
@@ -93,15 +236,29 @@ float fabsf(float x) {
 #endif
 
 int main(int argc, char** argv) {
-    if (argc > 1) {
-        if (strcmp(argv[1], "--editor") == 0) editor_mode_enabled = true;
+    bool perf_map_enabled = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--editor") == 0) editor_mode_enabled = true;
+        if (strcmp(argv[i], "--perf-map") == 0) perf_map_enabled = true;
+        if (strcmp(argv[i], "--profile") == 0) {
+            engine_set_profiling(true);
+            profile_enabled = true;
+        }
+        if (strcmp(argv[i], "--capture") == 0) capture_toggle();
+        if (strcmp(argv[i], "--uncapped") == 0) pacing_set_mode(Pacing_Uncapped, 0);
+        if (strcmp(argv[i], "--vsync") == 0) pacing_set_mode(Pacing_VSync, 0);
+        if (strcmp(argv[i], "--adaptive-vsync") == 0) pacing_set_mode(Pacing_Adaptive, 0);
+        if (strncmp(argv[i], "--fps=", 6) == 0) pacing_set_mode(Pacing_Limit, atof(argv[i] + 6));
     }
 
+    uint64_t startup = get_micros();
     jitc_context = jitc_create_context();
     load_assets();
+    submit_compile_jobs();
     storage_init();
     audio_init();
     if (compilation_failed) return 1;
+    uint64_t assets_loaded = get_micros();
 
     window = graphics_open("Compile Progress", 256, 64);
     if (!jitc_build(jitc_context, compile_progress)) {
@@ -109,13 +266,21 @@ int main(int argc, char** argv) {
         return 1;
     }
     graphics_close(window);
+    uint64_t scripts_built = get_micros();
+    report_unit_times();
+    report_asset_times();
+    if (perf_map_enabled) perf_map_open();
 
     void(*entry_point)() = jitc_get(jitc_context, "entry_point");
     if (!entry_point) {
         jitc_report_error(jitc_context, stderr);
         return 1;
     }
+    report_startup(assets_loaded - startup, scripts_built - assets_loaded, get_micros() - startup);
     entry_point();
+    capture_finish();
+    pacing_report();
+    if (engine_profiling) report_profile();
 
     return 0;
 }
@@ -123,3 +288,9 @@ int main(int argc, char** argv) {
 bool check_editor_mode() {
     return editor_mode_enabled;
 }
+
+void* get_script_symbol(const char* name) {
+    void* symbol = jitc_get(jitc_context, name);
+    if (!symbol && reload_compile_deferred(name)) symbol = jitc_get(jitc_context, name);
+    return symbol;
+}
@@ -5,7 +5,10 @@
 
 extern jitc_context_t* jitc_context;
 
+void hash_compile_input(const char* filename, const char* code);
 void add_compile_job(const char* code, const char* filename);
+void add_header(const char* code, const char* filename);
 bool check_editor_mode();
+void* get_script_symbol(const char* name);
 
 #endif
@@ -0,0 +1,138 @@
+#include "pacing.h"
+#include "io/platform.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+
+#define DEFAULT_RATE 60
+#define LATE_FACTOR 1.5 // a frame this much longer than the refresh interval missed a vblank
+#define ADAPTIVE_LATE_FRAMES 3 // late frames in a row before emulated adaptive sync stops waiting for vblank
+#define ADAPTIVE_EARLY_FRAMES 60 // frames in a row that would have made it before it waits again
+#define INTERVAL_UNKNOWN 2 // the backends pick their own swap interval until the mode is first applied
+#define SLEEP_QUANTUM 1000000 // the limiter sleeps this many ns at a time and spins once another sleep could overshoot
+
+typedef struct {
+    uint64_t count;
+    double mean, m2;
+} RunningStats;
+
+static PacingMode mode = Pacing_VSync;
+static float limit_rate = DEFAULT_RATE;
+static bool mode_changed = true;
+
+static Window* window; // the one the mode was applied to
+static int interval = INTERVAL_UNKNOWN;
+static bool native_adaptive;
+static int late_frames, early_frames;
+static uint64_t last_frame, deadline;
+
+static RunningStats sleeps = { 1, SLEEP_QUANTUM * 2, 0 }; // how long a SLEEP_QUANTUM sleep really takes
+static RunningStats frame_times;
+static uint64_t missed, worst;
+
+static const char* mode_names[] = { "uncapped", "vsync", "limit", "adaptive" };
+
+// welford's method, the plain sum of squares loses too much precision over a long session
+static void add_sample(RunningStats* stats, double value) {
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+}
+
+static double deviation(RunningStats* stats) {
+    return stats->count > 1 ? sqrt(stats->m2 / (stats->count - 1)) : 0;
+}
+
+static bool set_interval(Window* w, int value) {
+    if (interval == value) return true;
+    if (!graphics_set_vsync(w, value)) return false;
+    interval = value;
+    return true;
+}
+
+static void apply_mode(Window* w) {
+    window = w;
+    interval = INTERVAL_UNKNOWN;
+    if (mode == Pacing_VSync) set_interval(w, 1);
+    else if (mode == Pacing_Adaptive) {
+        native_adaptive = set_interval(w, -1);
+        if (!native_adaptive) set_interval(w, 1);
+    }
+    else set_interval(w, 0);
+    late_frames = early_frames = 0;
+    last_frame = 0;
+    deadline = get_nanos();
+    mode_changed = false;
+}
+
+// without driver support, adaptive sync is emulated by turning vsync off after a few late frames
+// and back on once frames have been fast enough for a while
+static void adapt(Window* w, bool late, bool early) {
+    late_frames = late ? late_frames + 1 : 0;
+    early_frames = early ? early_frames + 1 : 0;
+    if (interval == 1 && late_frames >= ADAPTIVE_LATE_FRAMES) set_interval(w, 0);
+    if (interval == 0 && early_frames >= ADAPTIVE_EARLY_FRAMES) set_interval(w, 1);
+}
+
+// sleeps are only as precise as the scheduler, so stop sleeping while one could still overshoot and spin the rest
+static uint64_t wait_until(uint64_t target) {
+    uint64_t now = get_nanos();
+    while (now + sleeps.mean + deviation(&sleeps) < target) {
+        sleep_nanos(SLEEP_QUANTUM);
+        uint64_t after = get_nanos();
+        add_sample(&sleeps, after - now);
+        now = after;
+    }
+    while (now < target) now = get_nanos();
+    return now;
+}
+
+// stats start over with the new mode
+// the mode can come from a script, anything outside of the enum keeps the current one
+void pacing_set_mode(PacingMode new_mode, float rate) {
+    if ((unsigned)new_mode >= sizeof(mode_names) / sizeof(*mode_names)) {
+        printf("Unknown frame pacing mode %d, keeping %s\n", (int)new_mode, mode_names[mode]);
+        return;
+    }
+    mode = new_mode;
+    limit_rate = rate > 0 ? rate : DEFAULT_RATE;
+    mode_changed = true;
+    frame_times = (RunningStats){ 0 };
+    missed = worst = 0;
+}
+
+// called once the frame is presented
+void pacing_end_frame(Window* w) {
+    if (mode_changed || window != w) apply_mode(w);
+    float rate = mode == Pacing_Limit ? limit_rate : mode == Pacing_Uncapped ? 0 : graphics_refresh_rate(w);
+    uint64_t period = rate > 0 ? 1000000000 / rate : 0;
+    uint64_t now = get_nanos();
+    bool late = false;
+    if (mode == Pacing_Limit) {
+        deadline += period;
+        late = now > deadline;
+        if (late) deadline = now; // start over instead of rushing the next frames to catch up
+        else now = wait_until(deadline);
+    }
+    else if (period && last_frame) late = now - last_frame > period * LATE_FACTOR;
+    if (mode == Pacing_Adaptive && !native_adaptive && period && last_frame) adapt(w, late, now - last_frame < period);
+    if (last_frame) {
+        uint64_t frame_time = now - last_frame;
+        add_sample(&frame_times, frame_time);
+        if (frame_time > worst) worst = frame_time;
+        if (late) missed++;
+    }
+    last_frame = now;
+}
+
+void pacing_report() {
+    if (frame_times.count == 0) return;
+    printf("Frame pacing (%s", mode_names[mode]);
+    if (mode == Pacing_Limit) printf(" at %.0f fps", limit_rate);
+    if (mode == Pacing_Adaptive) printf(", %s", native_adaptive ? "driver" : "emulated");
+    printf("): %" PRIu64 " frames, %.2f ms mean, %.2f ms jitter, %.2f ms worst, %" PRIu64 " missed deadlines\n",
+        frame_times.count, frame_times.mean / 1e6, deviation(&frame_times) / 1e6, worst / 1e6, missed
+    );
+}
@@ -0,0 +1,17 @@
+#ifndef PACING_H
+#define PACING_H
+
+#include "io/graphics.h"
+
+typedef enum {
+    Pacing_Uncapped,
+    Pacing_VSync,
+    Pacing_Limit,    // sleeps and then spins until the next frame of a fixed rate is due
+    Pacing_Adaptive, // vsync while frames are on time, presents right away when they're late
+} PacingMode;
+
+void pacing_set_mode(PacingMode mode, float rate);
+void pacing_end_frame(Window* window);
+void pacing_report();
+
+#endif
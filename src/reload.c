@@ -0,0 +1,601 @@
+#include "reload.h"
+#include "main.h"
+#include "source.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "io/platform.h"
+
+#define PERF_MAP_LAST_SIZE 0x10000 // upper bound for the size of a function
+#define DEFERRED_PREFIX "scripts/levels/"
+#define MAX_PREFETCH 8
+#define MAX_RELOADS 32
+#define RELOAD_DEBOUNCE 50000 // how long a file has to stay untouched before it's reloaded
+
+// every script and header keeps the units it #depends on or #includes, when a file changes
+// it gets recompiled along with the units that depend on it, but only if its interface changed,
+// scripts also keep their function definitions so they can be listed in a perf map,
+// changed files are read and analysed on a background thread and swapped in at the start of a frame,
+// the recompile itself still happens on the main thread since the jitc context is shared with the game
+
+typedef struct {
+    char* name;
+    int line;
+} ScriptFunc;
+
+typedef struct {
+    char* name; // relative to assets/, same as in #depends
+    bool header, deferred;
+    uint64_t interface;
+    int num_deps;
+    char** deps;
+    int num_funcs;
+    ScriptFunc* funcs;
+} ScriptUnit;
+
+typedef struct {
+    char* path;
+    char* code;
+    ScriptUnit unit; // interface, deps and funcs of the new source
+    uint64_t micros;
+} PreparedReload;
+
+typedef struct {
+    uintptr_t addr;
+    ScriptUnit* unit;
+    ScriptFunc* func;
+} PerfMapEntry;
+
+static int num_units, units_capacity;
+static ScriptUnit* units;
+
+static FILE* perf_map;
+
+static pthread_mutex_t reload_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reload_cond = PTHREAD_COND_INITIALIZER;
+static bool reload_thread_started, preparing, announced;
+static uint64_t last_request;
+static int num_requests, num_prepared;
+static PreparedReload requests[MAX_RELOADS]; // only path and unit.header are set
+static PreparedReload prepared[MAX_RELOADS];
+
+static int num_prefetch;
+static char* prefetch[MAX_PREFETCH];
+
+static char* copy_string(const char* str, size_t length) {
+    char* copy = malloc(length + 1);
+    memcpy(copy, str, length);
+    copy[length] = 0;
+    return copy;
+}
+
+// collects the names in #depends "..." and #include "..." lines
+static void parse_deps(ScriptUnit* unit, const char* code) {
+    for (int i = 0; i < unit->num_deps; i++) free(unit->deps[i]);
+    free(unit->deps);
+    unit->num_deps = 0;
+    unit->deps = NULL;
+    int capacity = 0;
+    for (const char* line = code; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+        while (*line == ' ' || *line == '\t') line++;
+        if (*line != '#') continue;
+        line++;
+        while (*line == ' ' || *line == '\t') line++;
+        if (strncmp(line, "depends", 7) != 0 && strncmp(line, "include", 7) != 0) continue;
+        const char* start = strchr(line, '"');
+        const char* newline = strchr(line, '\n');
+        if (!start || (newline && start > newline)) continue;
+        const char* end = strchr(start + 1, '"');
+        if (!end || (newline && end > newline)) continue;
+        if (unit->num_deps == capacity) {
+            capacity = capacity == 0 ? 4 : capacity * 2;
+            unit->deps = realloc(unit->deps, sizeof(char*) * capacity);
+        }
+        unit->deps[unit->num_deps++] = copy_string(start + 1, end - start - 1);
+    }
+}
+
+static const char* skip_space(const char* c, int* line) {
+    while (*c) {
+        if (c[0] == '/' && (c[1] == '/' || c[1] == '*')) {
+            const char* end = source_skip_comment(c);
+            for (; c < end; c++) if (*c == '\n') (*line)++;
+            continue;
+        }
+        if (*c != ' ' && *c != '\t' && *c != '\r' && *c != '\n') break;
+        if (*c++ == '\n') (*line)++;
+    }
+    return c;
+}
+
+// skips a balanced (), {} or [] group, or a string literal
+static const char* skip_group(const char* c, int* line) {
+    int depth = 0;
+    while (*c) {
+        if (*c == '"' || *c == '\'') {
+            const char* end = source_skip_literal(c);
+            for (; c < end; c++) if (*c == '\n') (*line)++;
+            if (depth == 0) return c;
+            continue;
+        }
+        if (c[0] == '/' && (c[1] == '/' || c[1] == '*')) {
+            c = skip_space(c, line);
+            continue;
+        }
+        if (*c == '\n') (*line)++;
+        if (*c == '(' || *c == '{' || *c == '[') depth++;
+        if ((*c == ')' || *c == '}' || *c == ']') && --depth == 0) return c + 1;
+        c++;
+    }
+    return c;
+}
+
+// collects the top level function definitions, either with a body or an -> expression, and named lambdas
+static void parse_funcs(ScriptUnit* unit, const char* code) {
+    for (int i = 0; i < unit->num_funcs; i++) free(unit->funcs[i].name);
+    free(unit->funcs);
+    unit->num_funcs = 0;
+    unit->funcs = NULL;
+    int capacity = 0, line = 1;
+    const char* ident = NULL;
+    int ident_length = 0, ident_line = 0;
+    const char* c = code;
+    while (*c) {
+        c = skip_space(c, &line);
+        if (!*c) break;
+        if (*c == '#') {
+            while (*c && *c != '\n') c++;
+            continue;
+        }
+        if (*c == '"' || *c == '\'') {
+            c = source_skip_literal(c);
+            continue;
+        }
+        if (source_is_ident(*c)) {
+            ident = c;
+            ident_line = line;
+            while (source_is_ident(*c)) c++;
+            ident_length = c - ident;
+            continue;
+        }
+        if (*c == '{' || *c == '[') {
+            c = skip_group(c, &line);
+            continue;
+        }
+        if (*c != '(') {
+            if (*c == ';' || *c == '=') ident = NULL;
+            c++;
+            continue;
+        }
+        const char* name = ident;
+        c = skip_space(skip_group(c, &line), &line);
+        if (!name || (*c != '{' && !(c[0] == '-' && c[1] == '>'))) continue;
+        if (unit->num_funcs == capacity) {
+            capacity = capacity == 0 ? 16 : capacity * 2;
+            unit->funcs = realloc(unit->funcs, sizeof(ScriptFunc) * capacity);
+        }
+        unit->funcs[unit->num_funcs++] = (ScriptFunc){ copy_string(name, ident_length), ident_line };
+        if (*c == '{') c = skip_group(c, &line);
+        else while (*c && *c != ';') {
+            if (*c == '(' || *c == '{' || *c == '[' || *c == '"' || *c == '\'') c = skip_group(c, &line);
+            else if (*c++ == '\n') line++;
+        }
+        ident = NULL;
+    }
+    // named lambdas inside of function bodies
+    line = 1;
+    for (c = code; *c; c++) {
+        if (*c == '\n') line++;
+        if (strncmp(c, "lambda", 6) != 0 || (c != code && source_is_ident(c[-1])) || source_is_ident(c[6])) continue;
+        const char* name = c + 6;
+        while (*name == ' ' || *name == '\t') name++;
+        const char* end = name;
+        while (source_is_ident(*end)) end++;
+        const char* paren = end;
+        while (*paren == ' ' || *paren == '\t') paren++;
+        if (end == name || *paren != '(') continue;
+        if (unit->num_funcs == capacity) {
+            capacity = capacity == 0 ? 16 : capacity * 2;
+            unit->funcs = realloc(unit->funcs, sizeof(ScriptFunc) * capacity);
+        }
+        unit->funcs[unit->num_funcs++] = (ScriptFunc){ copy_string(name, end - name), line };
+    }
+}
+
+static int find_unit(const char* name) {
+    for (int i = 0; i < num_units; i++) {
+        if (strcmp(units[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static bool depends_on(ScriptUnit* unit, const char* name) {
+    for (int i = 0; i < unit->num_deps; i++) {
+        if (strcmp(unit->deps[i], name) == 0) return true;
+    }
+    return false;
+}
+
+void reload_register(const char* filename, const char* code, bool header) {
+    int index = find_unit(filename);
+    if (index < 0) {
+        if (num_units == units_capacity) {
+            units_capacity = units_capacity == 0 ? 16 : units_capacity * 2;
+            units = realloc(units, sizeof(ScriptUnit) * units_capacity);
+        }
+        index = num_units++;
+        units[index] = (ScriptUnit){ .name = strdup(filename) };
+    }
+    units[index].header = header;
+    units[index].interface = source_hash_interface(code);
+    parse_deps(&units[index], code);
+    if (!header) parse_funcs(&units[index], code);
+}
+
+static int compare_perf_entry(const void* a, const void* b) {
+    uintptr_t x = ((PerfMapEntry*)a)->addr, y = ((PerfMapEntry*)b)->addr;
+    return x < y ? -1 : x > y;
+}
+
+// perf only reads start and size, the size of a function is taken as the distance to the next one
+static void write_perf_map(bool* only) {
+    if (!perf_map) return;
+    int num_entries = 0;
+    for (int i = 0; i < num_units; i++) num_entries += units[i].num_funcs;
+    PerfMapEntry* entries = malloc(sizeof(PerfMapEntry) * (num_entries + 1));
+    num_entries = 0;
+    for (int i = 0; i < num_units; i++) for (int j = 0; j < units[i].num_funcs; j++) {
+        void* addr = jitc_get(jitc_context, units[i].funcs[j].name);
+        if (addr) entries[num_entries++] = (PerfMapEntry){ (uintptr_t)addr, &units[i], &units[i].funcs[j] };
+    }
+    qsort(entries, num_entries, sizeof(PerfMapEntry), compare_perf_entry);
+    for (int i = 0; i < num_entries; i++) {
+        if (i > 0 && entries[i].addr == entries[i - 1].addr) continue; // methods sharing a name resolve to the same symbol
+        if (only && !only[entries[i].unit - units]) continue;
+        uintptr_t size = i + 1 < num_entries ? entries[i + 1].addr - entries[i].addr : PERF_MAP_LAST_SIZE;
+        if (size > PERF_MAP_LAST_SIZE) size = PERF_MAP_LAST_SIZE;
+        fprintf(perf_map, "%" PRIxPTR " %" PRIxPTR " %s [%s:%d]\n",
+            entries[i].addr, size, entries[i].func->name, entries[i].unit->name, entries[i].func->line
+        );
+    }
+    fflush(perf_map);
+    free(entries);
+}
+
+void perf_map_open() {
+#ifdef _WIN32
+    printf("perf maps are not supported on this platform\n");
+#else
+    char filename[64];
+    snprintf(filename, sizeof(filename), "/tmp/perf-%d.map", (int)getpid());
+    perf_map = fopen(filename, "w");
+    if (!perf_map) {
+        printf("Failed to open '%s'\n", filename);
+        return;
+    }
+    write_perf_map(NULL);
+#endif
+}
+
+static bool recompile_unit(ScriptUnit* unit, const char* code) {
+    if (unit->header) {
+        jitc_create_header(jitc_context, unit->name, strdup(code));
+        return true;
+    }
+    char path[sizeof("assets/") + strlen(unit->name)];
+    strcpy(path, "assets/");
+    strcat(path, unit->name);
+    return jitc_parse_file(jitc_context, path);
+}
+
+static char* read_source(const char* path) {
+    size_t length;
+    char* data = map_file(path, &length);
+    if (!data) return NULL;
+    char* code = copy_string(data, length);
+    unmap_file(data, length);
+    return code;
+}
+
+static void free_unit_lists(ScriptUnit* unit) {
+    for (int i = 0; i < unit->num_deps; i++) free(unit->deps[i]);
+    for (int i = 0; i < unit->num_funcs; i++) free(unit->funcs[i].name);
+    free(unit->deps);
+    free(unit->funcs);
+}
+
+// runs on the reload thread, only reads the file and works out what changed without touching units
+static void prepare_reload(PreparedReload* reload) {
+    uint64_t start = get_micros();
+    reload->code = read_source(reload->path);
+    if (reload->code) {
+        reload->unit.interface = source_hash_interface(reload->code);
+        parse_deps(&reload->unit, reload->code);
+        if (!reload->unit.header) parse_funcs(&reload->unit, reload->code);
+    }
+    reload->micros = get_micros() - start;
+}
+
+static void* reload_worker(void* arg) {
+    pthread_mutex_lock(&reload_mutex);
+    while (true) {
+        while (num_requests == 0) pthread_cond_wait(&reload_cond, &reload_mutex);
+        // editors write a file in several steps, wait until it has been quiet for a bit
+        uint64_t now;
+        while ((now = get_micros()) - last_request < RELOAD_DEBOUNCE) {
+            uint64_t wait = RELOAD_DEBOUNCE - (now - last_request);
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += (deadline.tv_nsec + wait * 1000) / 1000000000;
+            deadline.tv_nsec = (deadline.tv_nsec + wait * 1000) % 1000000000;
+            pthread_cond_timedwait(&reload_cond, &reload_mutex, &deadline);
+        }
+        int count = num_requests;
+        PreparedReload batch[MAX_RELOADS] = {};
+        memcpy(batch, requests, sizeof(PreparedReload) * count);
+        num_requests = 0;
+        preparing = true;
+        pthread_mutex_unlock(&reload_mutex);
+        for (int i = 0; i < count; i++) prepare_reload(&batch[i]);
+        pthread_mutex_lock(&reload_mutex);
+        for (int i = 0; i < count; i++) {
+            int slot;
+            while (true) {
+                for (slot = 0; slot < num_prepared && strcmp(prepared[slot].path, batch[i].path) != 0; slot++);
+                if (slot < num_prepared || num_prepared < MAX_RELOADS) break;
+                pthread_cond_wait(&reload_cond, &reload_mutex); // full, wait for reload_apply to take them
+            }
+            if (slot < num_prepared) { // an older version that hasn't been applied yet
+                free(prepared[slot].path);
+                free(prepared[slot].code);
+                free_unit_lists(&prepared[slot].unit);
+            }
+            else num_prepared++;
+            prepared[slot] = batch[i];
+        }
+        preparing = false;
+    }
+    return NULL;
+}
+
+// file watch callback, queues the file for the reload thread and returns right away,
+// called from check_watched_files on the main thread so units can be looked up here
+void reload_file(const char* path) {
+    pthread_mutex_lock(&reload_mutex);
+    if (!reload_thread_started) {
+        pthread_t thread;
+        reload_thread_started = pthread_create(&thread, NULL, reload_worker, NULL) == 0;
+        if (reload_thread_started) pthread_detach(thread);
+    }
+    bool queued = false;
+    for (int i = 0; i < num_requests && !queued; i++) queued = strcmp(requests[i].path, path) == 0;
+    if (!queued && num_requests == MAX_RELOADS) printf("Too many pending reloads, skipping '%s'\n", path);
+    else if (!queued) {
+        const char* name = strncmp(path, "assets/", 7) == 0 ? path + 7 : path;
+        int index = find_unit(name);
+        requests[num_requests++] = (PreparedReload){
+            .path = strdup(path),
+            .unit.header = index >= 0 && units[index].header,
+        };
+    }
+    last_request = get_micros();
+    pthread_cond_signal(&reload_cond);
+    pthread_mutex_unlock(&reload_mutex);
+}
+
+bool reload_pending() {
+    pthread_mutex_lock(&reload_mutex);
+    bool pending = num_requests > 0 || preparing || num_prepared > 0;
+    pthread_mutex_unlock(&reload_mutex);
+    return pending;
+}
+
+static void apply_reload(PreparedReload* reload) {
+    const char* path = reload->path;
+    const char* name = strncmp(path, "assets/", 7) == 0 ? path + 7 : path;
+    int changed = find_unit(name);
+    if (changed < 0 || !reload->code) return;
+    uint64_t start = get_micros();
+    uint64_t old_interface = units[changed].interface;
+    free_unit_lists(&units[changed]);
+    units[changed].interface = reload->unit.interface;
+    units[changed].num_deps = reload->unit.num_deps;
+    units[changed].deps = reload->unit.deps;
+    units[changed].num_funcs = reload->unit.num_funcs;
+    units[changed].funcs = reload->unit.funcs;
+    reload->unit = (ScriptUnit){};
+
+    // dependents of a unit with a changed interface see different declarations, so their interface changes too
+    bool queued[num_units];
+    memset(queued, 0, sizeof(queued));
+    queued[changed] = true;
+    int num_queued = 1;
+    if (units[changed].interface != old_interface) {
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (int i = 0; i < num_units; i++) {
+                if (queued[i]) continue;
+                for (int j = 0; j < num_units; j++) {
+                    if (!queued[j] || !depends_on(&units[i], units[j].name)) continue;
+                    queued[i] = grew = true;
+                    num_queued++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (num_queued > 1) printf("Reloading '%s' and %d dependents...", path, num_queued - 1);
+    else printf("Reloading '%s'...", path);
+    fflush(stdout);
+    // recompile in dependency order, a unit goes after every queued unit it depends on
+    bool done[num_units];
+    memset(done, 0, sizeof(done));
+    for (int remaining = num_queued; remaining > 0;) {
+        int next = -1;
+        for (int i = 0; i < num_units && next < 0; i++) {
+            if (!queued[i] || done[i]) continue;
+            next = i;
+            for (int j = 0; j < num_units; j++) {
+                if (queued[j] && !done[j] && j != i && depends_on(&units[i], units[j].name)) {
+                    next = -1;
+                    break;
+                }
+            }
+        }
+        if (next < 0) for (next = 0; !queued[next] || done[next]; next++); // cycle, take any
+        done[next] = true;
+        remaining--;
+        // scripts are parsed from their file, only headers need their source
+        char* source = next == changed ? reload->code : NULL;
+        if (!source && units[next].header) {
+            char path[sizeof("assets/") + strlen(units[next].name)];
+            strcpy(path, "assets/");
+            strcat(path, units[next].name);
+            source = read_source(path);
+        }
+        bool success = (source || !units[next].header) && recompile_unit(&units[next], source);
+        if (success) units[next].deferred = false;
+        if (source != reload->code) free(source);
+        if (!success) {
+            printf("\n");
+            jitc_report_error(jitc_context, stdout);
+            return;
+        }
+    }
+    printf("%.2f ms (prepared in %.2f ms)\n", (get_micros() - start) / 1000.f, reload->micros / 1000.f);
+    write_perf_map(queued);
+}
+
+// swaps in the prepared reloads, called at the start of a frame, returns whether anything got reloaded,
+// the recompile stalls the frame, so prepared reloads are held back for one frame that still reports
+// them as pending, that way the reloading indicator is what stays on screen while it compiles
+bool reload_apply() {
+    pthread_mutex_lock(&reload_mutex);
+    int count = num_prepared;
+    if (count > 0 && !announced) {
+        announced = true;
+        pthread_mutex_unlock(&reload_mutex);
+        return false;
+    }
+    announced = false;
+    PreparedReload batch[MAX_RELOADS];
+    memcpy(batch, prepared, sizeof(PreparedReload) * count);
+    num_prepared = 0;
+    pthread_cond_signal(&reload_cond);
+    pthread_mutex_unlock(&reload_mutex);
+    for (int i = 0; i < count; i++) {
+        apply_reload(&batch[i]);
+        free(batch[i].path);
+        free(batch[i].code);
+        free_unit_lists(&batch[i].unit);
+    }
+    return count > 0;
+}
+
+static bool depends_recursive(int index, const char* dep, bool* visited) {
+    if (visited[index]) return false;
+    visited[index] = true;
+    if (depends_on(&units[index], dep)) return true;
+    for (int i = 0; i < units[index].num_deps; i++) {
+        int next = find_unit(units[index].deps[i]);
+        if (next >= 0 && depends_recursive(next, dep, visited)) return true;
+    }
+    return false;
+}
+
+bool reload_depends(const char* name, const char* dep) {
+    int index = find_unit(name);
+    if (index < 0) return false;
+    bool visited[num_units];
+    memset(visited, 0, sizeof(visited));
+    return depends_recursive(index, dep, visited);
+}
+
+const char* reload_symbol_name(void* addr) {
+    for (int i = 0; i < num_units; i++) for (int j = 0; j < units[i].num_funcs; j++) {
+        if (jitc_get(jitc_context, units[i].funcs[j].name) == addr) return units[i].funcs[j].name;
+    }
+    return NULL;
+}
+
+static bool is_level_script(const char* name) {
+    return strncmp(name, DEFERRED_PREFIX, strlen(DEFERRED_PREFIX)) == 0;
+}
+
+// level scripts that only other levels depend on aren't compiled at startup,
+// they get compiled the first time one of their symbols is looked up
+bool reload_is_deferred(const char* name) {
+    int index = find_unit(name);
+    if (index < 0 || units[index].header || !is_level_script(name)) return false;
+    for (int i = 0; i < num_units; i++) {
+        if (!is_level_script(units[i].name) && depends_on(&units[i], name)) return false;
+    }
+    return units[index].deferred = true;
+}
+
+static bool compile_deferred_unit(int index) {
+    if (!units[index].deferred) return true;
+    units[index].deferred = false;
+    for (int i = 0; i < units[index].num_deps; i++) {
+        int dep = find_unit(units[index].deps[i]);
+        if (dep >= 0 && !compile_deferred_unit(dep)) return false;
+    }
+    uint64_t start = get_micros();
+    char path[sizeof("assets/") + strlen(units[index].name)];
+    strcpy(path, "assets/");
+    strcat(path, units[index].name);
+    printf("Compiling '%s'...", path);
+    fflush(stdout);
+    if (!jitc_parse_file(jitc_context, path)) {
+        printf("\n");
+        jitc_report_error(jitc_context, stdout);
+        return false;
+    }
+    printf("%.2f ms\n", (get_micros() - start) / 1000.f);
+    bool only[num_units];
+    memset(only, 0, sizeof(only));
+    only[index] = true;
+    write_perf_map(only);
+    return true;
+}
+
+bool reload_compile_deferred(const char* symbol) {
+    for (int i = 0; i < num_units; i++) {
+        if (!units[i].deferred) continue;
+        for (int j = 0; j < units[i].num_funcs; j++) {
+            if (strcmp(units[i].funcs[j].name, symbol) == 0) return compile_deferred_unit(i);
+        }
+    }
+    return false;
+}
+
+// queues a symbol to be compiled later from reload_compile_prefetched, so that e.g. the next level
+// is ready before it's needed without stalling the frame that loaded the current one
+void reload_prefetch(const char* symbol) {
+    if (num_prefetch == MAX_PREFETCH) return;
+    for (int i = 0; i < num_prefetch; i++) {
+        if (strcmp(prefetch[i], symbol) == 0) return;
+    }
+    prefetch[num_prefetch++] = strdup(symbol);
+}
+
+// compiles at most one queued unit per call
+void reload_compile_prefetched() {
+    if (num_prefetch == 0) return;
+    char* symbol = prefetch[0];
+    memmove(prefetch, prefetch + 1, sizeof(char*) * --num_prefetch);
+    reload_compile_deferred(symbol);
+    free(symbol);
+}
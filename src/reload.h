@@ -0,0 +1,18 @@
+#ifndef RELOAD_H
+#define RELOAD_H
+
+#include <stdbool.h>
+
+void reload_register(const char* filename, const char* code, bool header);
+void reload_file(const char* path);
+bool reload_pending();
+bool reload_apply();
+void perf_map_open();
+const char* reload_symbol_name(void* addr);
+bool reload_depends(const char* name, const char* dep);
+bool reload_is_deferred(const char* name);
+bool reload_compile_deferred(const char* symbol);
+void reload_prefetch(const char* symbol);
+void reload_compile_prefetched();
+
+#endif
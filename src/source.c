@@ -0,0 +1,136 @@
+#include "source.h"
+
+#include <string.h>
+
+static uint64_t hash_byte(uint64_t hash, uint8_t c) {
+    return (hash ^ c) * 0x100000001b3;
+}
+
+const char* source_skip_literal(const char* c) {
+    char quote = *c++;
+    while (*c && *c != quote) {
+        if (*c == '\\' && c[1]) c++;
+        c++;
+    }
+    return *c ? c + 1 : c;
+}
+
+const char* source_skip_comment(const char* c) {
+    if (c[1] == '/') {
+        while (*c && *c != '\n') c++;
+        return c;
+    }
+    c += 2;
+    while (*c && !(c[0] == '*' && c[1] == '/')) c++;
+    return *c ? c + 2 : c;
+}
+
+bool source_is_ident(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// skips a { } body, returns the position after the closing brace
+static const char* skip_block(const char* c) {
+    int depth = 0;
+    while (*c) {
+        if (*c == '"' || *c == '\'') {
+            c = source_skip_literal(c);
+            continue;
+        }
+        if (c[0] == '/' && (c[1] == '/' || c[1] == '*')) {
+            c = source_skip_comment(c);
+            continue;
+        }
+        if (*c == '{') depth++;
+        if (*c == '}' && --depth == 0) return c + 1;
+        c++;
+    }
+    return c;
+}
+
+// skips an -> expression body, it ends at a ; or , or at the bracket that closes around it, which are kept
+static const char* skip_expression(const char* c) {
+    int depth = 0;
+    while (*c) {
+        if (*c == '"' || *c == '\'') {
+            c = source_skip_literal(c);
+            continue;
+        }
+        if (c[0] == '/' && (c[1] == '/' || c[1] == '*')) {
+            c = source_skip_comment(c);
+            continue;
+        }
+        if (*c == '(' || *c == '{' || *c == '[') depth++;
+        else if (*c == ')' || *c == '}' || *c == ']') {
+            if (depth == 0) break;
+            depth--;
+        }
+        else if ((*c == ';' || *c == ',') && depth == 0) break;
+        c++;
+    }
+    return c;
+}
+
+// hashes everything except function and lambda bodies, comments and whitespace, so edits inside of a
+// function don't touch the units that depend on it, a body is either a { } block or an -> expression,
+// preprocessor lines are hashed as they are since macros are part of the interface
+uint64_t source_hash_interface(const char* code) {
+    uint64_t hash = 0xcbf29ce484222325;
+    char last = 0;
+    bool line_start = true, lambda = false; // lambda is set between the keyword and its body
+    const char* c = code;
+    while (*c) {
+        if (c[0] == '/' && (c[1] == '/' || c[1] == '*')) {
+            c = source_skip_comment(c);
+            continue;
+        }
+        if (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+            if (*c++ == '\n') line_start = true;
+            continue;
+        }
+        if (*c == '#' && line_start) {
+            for (; *c && !(*c == '\n' && c[-1] != '\\'); c++) {
+                if (*c != ' ' && *c != '\t' && *c != '\r' && *c != '\\') hash = hash_byte(hash, *c);
+            }
+            hash = hash_byte(hash, '\n');
+            last = 0;
+            continue;
+        }
+        line_start = false;
+        bool body = last == ')' || lambda;
+        if (*c == '{' && body) {
+            c = skip_block(c);
+            hash = hash_byte(hash, '{');
+            hash = hash_byte(hash, '}');
+            last = '}';
+            lambda = false;
+            continue;
+        }
+        if (c[0] == '-' && c[1] == '>' && body) {
+            c = skip_expression(c + 2);
+            hash = hash_byte(hash, '-');
+            hash = hash_byte(hash, '>');
+            last = '>';
+            lambda = false;
+            continue;
+        }
+        if (*c == '"' || *c == '\'') {
+            const char* end = source_skip_literal(c);
+            while (c < end) hash = hash_byte(hash, *c++);
+            last = end[-1];
+            continue;
+        }
+        if (source_is_ident(*c) && (c == code || !source_is_ident(c[-1]))) {
+            const char* end = c;
+            while (source_is_ident(*end)) end++;
+            if (end - c == 6 && strncmp(c, "lambda", 6) == 0) lambda = true;
+            while (c < end) hash = hash_byte(hash, *c++);
+            last = end[-1];
+            continue;
+        }
+        if (*c == ';') lambda = false;
+        hash = hash_byte(hash, *c);
+        last = *c++;
+    }
+    return hash;
+}
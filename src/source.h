@@ -0,0 +1,14 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// scanning helpers for script sources, they don't depend on jitc so they can be tested on their own
+
+const char* source_skip_literal(const char* c);
+const char* source_skip_comment(const char* c);
+bool source_is_ident(char c);
+uint64_t source_hash_interface(const char* code);
+
+#endif
@@ -0,0 +1,70 @@
+#include "source.h"
+
+#include <stdio.h>
+
+// edits that stay inside of a body have to keep the interface hash, otherwise a reload
+// recompiles every dependent and resets their globals
+
+static int failed;
+
+static void check(const char* name, const char* before, const char* after, bool same) {
+    bool equal = source_hash_interface(before) == source_hash_interface(after);
+    if (equal == same) return;
+    printf("FAIL %s: interface hash %s\n", name, equal ? "didn't change" : "changed");
+    failed++;
+}
+
+int main() {
+    check("function body",
+        "int f(int x) { return x + 1; }\n",
+        "int f(int x) {\n    int y = x * 2; // comment\n    return y + \"}\"[0];\n}\n",
+        true
+    );
+    check("expression body",
+        "bool hovering(int x, int y) -> input.mouse_x() >= x && input.mouse_y() >= y;\n",
+        "bool hovering(int x, int y) -> input.mouse_x() > x && (input.mouse_y() > y || \";\");\n",
+        true
+    );
+    check("method expression body",
+        "void reload(Engine* this) -> this.load(curr_loader);\nint g;\n",
+        "void reload(Engine* this) -> this.load(other_loader, 1);\nint g;\n",
+        true
+    );
+    check("lambda block body",
+        "Update on_update = lambda update(EntityNode* e): void { e.x += 1; };\n",
+        "Update on_update = lambda update(EntityNode* e): void { e.x -= 2; if (e.x < 0) { e.x = 0; } };\n",
+        true
+    );
+    check("lambda expression body",
+        "Tile(*decorate)(int x) = lambda(int x): Tile -> x > 1 ? 2 : 3;\n",
+        "Tile(*decorate)(int x) = lambda(int x): Tile -> (x + 4) % 5;\n",
+        true
+    );
+    check("lambda inside of an expression body",
+        "Node* level() -> engine.open().event(lambda tick(): void { step(1); }).close();\n",
+        "Node* level() -> engine.open().event(lambda tick(): void { step(2); step(3); }).close();\n",
+        true
+    );
+    check("signature",
+        "int f(int x) -> x;\n",
+        "int f(float x) -> x;\n",
+        false
+    );
+    check("global after an expression body",
+        "int f() -> 1;\nint counter;\n",
+        "int f() -> 1;\nfloat counter;\n",
+        false
+    );
+    check("lambda return type",
+        "Update u = lambda(): int { return 0; };\n",
+        "Update u = lambda(): float { return 0; };\n",
+        false
+    );
+    check("macro",
+        "#define SCALE(x) ((x) * 2)\nint f() -> 1;\n",
+        "#define SCALE(x) ((x) * 3)\nint f() -> 1;\n",
+        false
+    );
+    if (failed == 0) printf("source: all passed\n");
+    return failed != 0;
+}